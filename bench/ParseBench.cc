@@ -0,0 +1,114 @@
+/***********************************************************************************[ParseBench.cc]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+// Measures the tokenizer of the DIMACS parser alone, without the solver behind it: the CPU time
+// to read every integer of a file from the memory mapping eight digits at a time ('mapped'), from
+// the memory mapping one digit at a time ('scalar') and through zlib ('stream', the path of gzip
+// files and pipes). The best time of a number of runs is printed for each reader, with the sum of
+// the integers read, which must be the same for the three readers. The times include the mapping
+// or the opening of the file.
+//
+// usage: bench_parse <cnf-file>... [-runs=<n>]
+
+#include <math.h>
+#include <zlib.h>
+
+#include <algorithm>
+
+#include "minisat/utils/ParseUtils.h"
+#include "minisat/utils/Options.h"
+#include "minisat/utils/System.h"
+
+using namespace Minisat;
+
+template<class B>
+static int64_t readDigitsAtOnce(B& in) { return parseInt(in); }
+
+template<class B>
+static int64_t readDigitByDigit(B& in) { return parseInt<B>(in); }
+
+// Reads every integer of 'in', skipping the comments and the header.
+template<class B, int64_t (*read)(B&)>
+static int64_t tokenize(B& in) {
+    int64_t sum = 0;
+    for (;;){
+        skipWhitespace(in);
+        if (isEof(in)) break;
+        if (*in == 'c' || *in == 'p') skipLine(in);
+        else                          sum += read(in); }
+    return sum; }
+
+static int64_t readMapped(const char* file, bool at_once) {
+    MappedBuffer in(file);
+    if (!in.mapped())
+        fprintf(stderr, "ERROR! Could not map file: %s\n", file), exit(1);
+    return at_once ? tokenize<MappedBuffer, readDigitsAtOnce<MappedBuffer> >(in)
+                   : tokenize<MappedBuffer, readDigitByDigit<MappedBuffer> >(in); }
+
+static int64_t readStream(const char* file) {
+    gzFile f = gzopen(file, "rb");
+    if (f == NULL)
+        fprintf(stderr, "ERROR! Could not open file: %s\n", file), exit(1);
+    int64_t sum;
+    {
+        StreamBuffer in(f);
+        sum = tokenize<StreamBuffer, readDigitByDigit<StreamBuffer> >(in);
+    }
+    gzclose(f);
+    return sum; }
+
+// CPU time of one read of 'file' by 'reader' (0: mapped, 1: scalar, 2: stream). Small files are
+// read again until 'min_time' is spent, the time is the average of these reads.
+static double timeReader(const char* file, int reader, double min_time, int64_t& sum) {
+    double start = cpuTime();
+    double spent;
+    int    reads = 0;
+    do {
+        sum   = reader == 2 ? readStream(file) : readMapped(file, reader == 0);
+        spent = cpuTime() - start;
+        reads++;
+    } while (spent < min_time);
+    return spent / reads; }
+
+
+int main(int argc, char** argv)
+{
+    setUsageHelp("USAGE: %s [options] <cnf-file>...\n\n  Uncompressed files only.\n");
+    IntOption runs("MAIN", "runs", "Runs per file and reader, the best time is printed.", 5, IntRange(1, INT32_MAX));
+    parseOptions(argc, argv, true);
+
+    printf("%-24s %10s %10s %10s %8s %8s  %s\n", "instance", "mapped(s)", "scalar(s)", "stream(s)",
+           "/scalar", "/stream", "sum");
+    for (int i = 1; i < argc; i++){
+        const char* file = argv[i];
+        const char* name = strrchr(file, '/') ? strrchr(file, '/') + 1 : file;
+        double  best[3]  = { HUGE_VAL, HUGE_VAL, HUGE_VAL };
+        int64_t sums[3]  = { 0, 0, 0 };
+        for (int r = 0; r < runs; r++)
+            for (int k = 0; k < 3; k++)
+                best[k] = std::min(best[k], timeReader(file, k, 0.1, sums[k]));
+
+        if (sums[0] != sums[1] || sums[0] != sums[2])
+            fprintf(stderr, "ERROR! The readers disagree on %s\n", file), exit(1);
+        printf("%-24s %10.5f %10.5f %10.5f %8.2f %8.2f  %" PRId64"\n", name, best[0], best[1], best[2],
+               best[1] / best[0], best[2] / best[0], sums[0]);
+    }
+    return 0;
+}
@@ -51,8 +51,17 @@ static void readClause(B& in, Solver& S, vec<Lit>& lits) {
 	}
 }
 
-template<class B, class Solver>
-static void parse_DIMACS_main(B& in, Solver& S) {
+// Clause sink which ignores the clauses, for the parses feeding the solver only.
+struct NoClauseSink {
+	void reserve(int, int) {}
+	template<class Lits> void addClause(const Lits&) {}
+};
+
+// Every clause read is given to 'sink' (if not NULL) as written in the file, then to the solver
+// which may simplify it: the problem is decompressed and tokenized only once. The sizes of the
+// header are given to 'sink' before the clauses.
+template<class B, class Solver, class Sink>
+static void parse_DIMACS_main(B& in, Solver& S, Sink* sink) {
 	vec<Lit> lits;
 	int vars    = 0;
 	int clauses = 0;
@@ -64,6 +73,7 @@ static void parse_DIMACS_main(B& in, Solver& S) {
 			if (eagerMatch(in, "p cnf")){
 				vars    = parseInt(in);
 				clauses = parseInt(in);
+				if (sink != NULL) sink->reserve(vars, clauses);
 				// SATRACE'06 hack
 				// if (clauses > 4000000)
 				//     S.eliminate(true);
@@ -75,6 +85,7 @@ static void parse_DIMACS_main(B& in, Solver& S) {
 		else{
 			cnt++;
 			readClause(in, S, lits);
+			if (sink != NULL) sink->addClause(lits);
 			S.addClause_(lits); }
 	}
 	if (vars != S.nVars())
@@ -83,6 +94,10 @@ static void parse_DIMACS_main(B& in, Solver& S) {
 		fprintf(stderr, "WARNING! DIMACS header mismatch: wrong number of clauses.\n");
 }
 
+template<class B, class Solver>
+static void parse_DIMACS_main(B& in, Solver& S) {
+	parse_DIMACS_main(in, S, (NoClauseSink*)NULL); }
+
 // Symmetry is a commented line with cycles.
 // The line starts with "c", followed by a blank, followed by the permutation cycles comprised of literals, followed by a blank followed by a zero.
 // Every literal in a cycle is either a positive or negative literal.
@@ -146,6 +161,32 @@ static void parse_DIMACS(gzFile input_stream, Solver& S) {
 	StreamBuffer in(input_stream);
 	parse_DIMACS_main(in, S); }
 
+// Inserts problem into solver, and each original clause into 'sink'.
+//
+template<class Solver, class Sink>
+static void parse_DIMACS(gzFile input_stream, Solver& S, Sink* sink) {
+	StreamBuffer in(input_stream);
+	parse_DIMACS_main(in, S, sink); }
+
+// Inserts the problem in file 'filename' into solver, and each original clause into 'sink'.
+// Uncompressed files are mapped in memory and parsed in place, the others are read through zlib.
+// Returns false if the file cannot be opened.
+template<class Solver, class Sink>
+static bool parse_DIMACS(const char* filename, Solver& S, Sink* sink) {
+	MappedBuffer mapped(filename);
+	if (mapped.mapped()){
+		parse_DIMACS_main(mapped, S, sink);
+		return true; }
+	gzFile input_stream = gzopen(filename, "rb");
+	if (input_stream == NULL) return false;
+	parse_DIMACS(input_stream, S, sink);
+	gzclose(input_stream);
+	return true; }
+
+template<class Solver>
+static bool parse_DIMACS(const char* filename, Solver& S) {
+	return parse_DIMACS(filename, S, (NoClauseSink*)NULL); }
+
 // Inserts symmetry into solver.
 //
 template<class Solver>
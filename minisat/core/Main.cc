@@ -34,6 +34,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "minisat/utils/ParseUtils.h"
 #include "minisat/utils/Options.h"
 #include "minisat/core/Dimacs.h"
+#include "minisat/core/Snapshot.h"
 #include "minisat/core/Solver.h"
 
 #include "minisat/core/MinisatLiteralAdapter.h"
@@ -58,6 +59,48 @@ static void SIGINT_exit(int) {
     _exit(1); }
 
 
+// Gives the generators found in-process by cosy to the symmetry propagation, as 'parse_SYMMETRY'
+// does for the generators of the symmetry file.
+static void addSymmetries(Solver& S, const cosy::SymmetryController<Lit>& symmetry) {
+    vec<Lit> from, to;
+    for (const std::unique_ptr<cosy::Permutation>& permutation : symmetry.group().permutations()){
+        from.clear(); to.clear();
+        for (unsigned int c = 0; c < permutation->numberOfCycles(); c++){
+            cosy::Literal element = permutation->lastElementInCycle(c);
+            for (const cosy::Literal& image : permutation->cycle(c)){
+                from.push(symmetry.convertFrom(element));
+                to.push(symmetry.convertFrom(image));
+                element = image; }
+        }
+        S.addSymmetry(from, to, permutation->table());
+    }
+}
+
+// Adds the clauses of the static symmetry breaking, after their auxiliary variables.
+static void addStaticBreaking(Solver& S, const cosy::SymmetryController<Lit>& symmetry) {
+    const cosy::StaticBreaker& breaker = *symmetry.staticBreaker();
+    while (S.nVars() < (int)breaker.numberOfVariables())
+        S.newVar();
+
+    vec<Lit> lits;
+    for (const cosy::ClauseView clause : breaker.clauses()){
+        lits.clear();
+        for (const cosy::Literal& literal : clause)
+            lits.push(symmetry.convertFrom(literal));
+        if (!S.addBreakingClause(lits))
+            break;
+    }
+}
+
+// Parses the problem from standard input when 'in' is open, from the file 'filename' otherwise.
+template<class Sink>
+static void parseProblem(gzFile in, const char* filename, Solver& S, Sink* sink) {
+    if (in != NULL){
+        parse_DIMACS(in, S, sink);
+        gzclose(in);
+    }else if (!parse_DIMACS(filename, S, sink))
+        printf("ERROR! Could not open file: %s\n", filename), exit(1); }
+
 //=================================================================================================
 // Main:
 
@@ -75,6 +118,18 @@ int main(int argc, char** argv)
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", 0, IntRange(0, INT32_MAX));
 	BoolOption   use_dynamic("MAIN", "dynamic-breaking","Use provided dynamic symmetry breaking.\n", true);
 	BoolOption   opt_cosy("MAIN", "cosy","Use provided dynamic symmetry breaking.\n", true);
+	StringOption sym_finder("MAIN", "sym-finder","Source of the symmetries: 'file' reads <input-file>.txt, 'bliss' or 'saucy' detects them in-process.\n", "file");
+	StringOption sym_cache("MAIN", "sym-cache","Directory caching the symmetries detected in-process, keyed by a hash of the clauses.\n");
+	IntOption    sym_cache_size("MAIN", "sym-cache-size","Size limit of the symmetry cache in megabytes, least recently used entries are evicted.\n", 1024, IntRange(1, INT32_MAX));
+	DoubleOption sym_time_lim("MAIN", "sym-time-lim","CPU time budget of the in-process symmetry detection in seconds, summed over its threads (0: half the time left by cpu-lim, if any).\n", 0, DoubleRange(0, true, HUGE_VAL, false));
+	IntOption    sym_node_lim("MAIN", "sym-node-lim","Search node budget of the in-process symmetry detection (0: none).\n", 0, IntRange(0, INT32_MAX));
+	IntOption    sym_gen_lim("MAIN", "sym-gen-lim","Generator budget of the in-process symmetry detection (0: none).\n", 0, IntRange(0, INT32_MAX));
+	IntOption    sym_threads("MAIN", "sym-threads","Threads of the in-process symmetry detection, on the components of the graph (0: one per core).\n", 0, IntRange(0, 1024));
+	BoolOption   sym_matrix("MAIN", "sym-matrix","Break the row and column interchangeability of the matrices found in the symmetries, with lex chains before search.\n", false);
+	BoolOption   sbp_static("MAIN", "sbp-static","Break the symmetries before search with lex-leader clauses, on the order of cosy.\n", false);
+	IntOption    sbp_size_lim("MAIN", "sbp-size-lim","Pairs of literals ordered per generator by sbp-static (0: none).\n", 50, IntRange(0, INT32_MAX));
+	StringOption sbp_export("MAIN", "sbp-export","Write the problem with the clauses of sbp-static in DIMACS.\n");
+	StringOption snapshot("MAIN", "snapshot","Binary snapshot of the problem and its symmetries: loaded if up to date with the input files, written otherwise.\n");
 
         parseOptions(argc, argv, true);
 
@@ -95,12 +150,20 @@ int main(int argc, char** argv)
         if (argc == 1)
             printf("Reading from standard input... Use '--help' for help.\n");
 
-        std::string cnf_file = std::string(argv[1]);
         std::string sym_file = std::string(argv[1]) + ".txt";
 
-        gzFile in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
-        if (in == NULL)
-            printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
+        // 0 for the symmetry file, else the in-process automorphism tool (1 + its cosy value):
+        int finder = 0;
+        if      (strcmp(sym_finder, "bliss") == 0) finder = 1 + cosy::SymmetryFinder::BLISS;
+        else if (strcmp(sym_finder, "saucy") == 0) finder = 1 + cosy::SymmetryFinder::SAUCY;
+        else if (strcmp(sym_finder, "file") != 0)
+            printf("ERROR! Unknown symmetry finder: %s\n", (const char*)sym_finder), exit(1);
+        bool in_process = finder != 0;
+
+        // Standard input is read through zlib, a file given by name is mapped when uncompressed:
+        gzFile in = NULL;
+        if (argc == 1 && (in = gzdopen(0, "rb")) == NULL)
+            printf("ERROR! Could not open file: <stdin>\n"), exit(1);
 
         if (S.verbosity > 0){
             printf("============================[ Problem Statistics ]=============================\n");
@@ -109,49 +172,152 @@ int main(int argc, char** argv)
 
 
 
-        parse_DIMACS(in, S);
-        gzclose(in);
+        // A snapshot up to date with the input files replaces their parse and the symmetry
+        // detection, otherwise it is recorded while they are read:
+        int needed = Snapshot::section_clauses;
+        if (opt_cosy || sbp_static || sym_matrix || (in_process && use_dynamic)) needed |= Snapshot::section_group;
+        if (use_dynamic && !in_process)              needed |= Snapshot::section_symmetries;
+
+        const char* snapshot_file = snapshot;
+        bool        use_snapshot  = argc > 1 && snapshot_file != NULL;
+        bool        from_snapshot = false;
+        Snapshot::FileStamp cnf_stamp = { 0, 0 };
+        Snapshot::FileStamp sym_stamp = { 0, 0 };
+        Snapshot    snap;
+        if (use_snapshot){
+            cnf_stamp     = Snapshot::FileStamp::of(argv[1]);
+            if (!in_process) sym_stamp = Snapshot::FileStamp::of(sym_file.c_str());
+            from_snapshot = snap.load(snapshot_file, cnf_stamp, sym_stamp, finder, needed); }
 
-        if (opt_cosy) {
+        // The clauses are shared with the cosy CNF model while parsing, instead of having cosy read
+        // the file a second time. The solver gets the controller once the problem is read: the
+        // units of the file are propagated while parsing, before cosy knows its variables, and are
+        // notified to cosy by 'solve' as in a run without sharing.
+        std::unique_ptr<cosy::SymmetryController<Minisat::Lit>> symmetry;
+        if (needed & Snapshot::section_group) {
             std::unique_ptr<cosy::LiteralAdapter<Minisat::Lit>> adapter
                 (new MinisatLiteralAdapter());
 
-            S.symmetry = std::unique_ptr<cosy::SymmetryController<Minisat::Lit>>
-                (new cosy::SymmetryController<Minisat::Lit>
-                 (cnf_file, sym_file,
-                  std::move(adapter)));
-        } else {
-            S.symmetry = nullptr;
+            symmetry = std::unique_ptr<cosy::SymmetryController<Minisat::Lit>>
+                (new cosy::SymmetryController<Minisat::Lit>(std::move(adapter)));
+            if (in_process && sym_cache != NULL)
+                symmetry->enableSymmetryCache((const char*)sym_cache, (int64_t)sym_cache_size << 20);
+            symmetry->setMatrixDetection(sym_matrix);
         }
 
-        if(use_dynamic){
-        	//parse symmetry file
-		char symFile[strlen(argv[1])+4];
-		strcpy(symFile,argv[1]);
-		strcat(symFile,".txt");
-		in=gzopen(symFile,"rb");
-
-		if (in != NULL){
-			parse_SYMMETRY(in,S);
-		}
-		gzclose(in);
+        if (from_snapshot)
+            snap.loadClauses(S, symmetry.get());
+        else if (use_snapshot){
+            snap.recordClauses(symmetry.get());
+            parseProblem(in, argv[1], S, &snap);
+            snap.recordSolver(S);
+        }else if (symmetry)
+            parseProblem(in, argv[1], S, symmetry.get());
+        else
+            parseProblem(in, argv[1], S, (NoClauseSink*)NULL);
+        S.symmetry = std::move(symmetry);
+
+        double cnf_parsed_time = cpuTime();
+        double cnf_parsed_mem  = memUsedPeak();
+
+        if (S.symmetry){
+            if (from_snapshot)
+                snap.loadGroup(*S.symmetry);
+            else if (in_process){
+                // Past its budget the detection keeps the generators found so far, so that the
+                // search still has time under cpu-lim:
+                cosy::SymmetryFinder::Budget budget;
+                budget.seconds    = sym_time_lim;
+                budget.nodes      = sym_node_lim;
+                budget.generators = sym_gen_lim;
+                budget.threads    = sym_threads;
+                if (budget.seconds == 0 && cpu_lim != 0)
+                    budget.seconds = cpu_lim > cpuTime() ? (cpu_lim - cpuTime()) / 2 : 0.001;
+                S.symmetry->setFinderBudget(budget);
+                S.symmetry->findSymmetries((cosy::SymmetryFinder::Automorphism)(finder - 1));
+            }
+            else
+                S.symmetry->loadSymmetries(sym_file);
+            if (use_snapshot && !from_snapshot)
+                snap.recordGroup(*S.symmetry);
         }
 
+        double symmetries_time     = cpuTime();
+        double symmetries_mem      = memUsedPeak();
+        bool   symmetries_complete = !S.symmetry || S.symmetry->symmetriesComplete();
+        // The group of cosy and of the static breaking, from the file or the finder. Its order is
+        // computed by the Schreier-Sims algorithm, up to a chain of 2^24 integers: as it is not
+        // bounded in time, only at -verb=2.
+        int    num_generators = S.symmetry ? S.symmetry->group().numberOfPermutations() : 0;
+        double group_order    = S.symmetry && S.verbosity > 1 ? S.symmetry->group().log10Order(1 << 24) : -1;
+
+        // In-process detection: one group, shared by cosy and the symmetry propagation.
+        if (S.symmetry && in_process && use_dynamic)
+            addSymmetries(S, *S.symmetry);
+
+        if (use_dynamic && !in_process){
+            if (from_snapshot)
+                snap.loadSymmetries(S);
+            else{
+                in = gzopen(sym_file.c_str(), "rb");
+                if (use_snapshot){
+                    snap.recordSymmetries(in);
+                    snap.loadSymmetries(S);
+                }else if (in != NULL)
+                    parse_SYMMETRY(in, S);
+                if (in != NULL) gzclose(in);
+            }
+        }
+
+        // The static breaking follows the symmetries of the propagation, which give the compatible
+        // symmetries of its clauses, and uses the order of cosy. Without sbp-static, only the lex
+        // chains of the matrices are added:
+        int num_vars = S.nVars();
+        if (S.symmetry && (sbp_static || sym_matrix)){
+            S.symmetry->enableStaticBreaking(cosy::OrderMode::AUTO, cosy::ValueMode::TRUE_LESS_FALSE, sbp_size_lim, !sbp_static);
+            addStaticBreaking(S, *S.symmetry);
+            if (sbp_export != NULL && !S.symmetry->writeStaticBreaking((const char*)sbp_export))
+                fprintf(stderr, "WARNING! Could not write static breaking: %s\n", (const char*)sbp_export);
+        }
+        if (!opt_cosy)
+            S.symmetry = nullptr;
+
+        // A partial group is not kept, a run with a larger budget may find more symmetries:
+        bool save_snapshot = use_snapshot && !from_snapshot && symmetries_complete;
+        if (save_snapshot && !snap.save(snapshot_file, cnf_stamp, sym_stamp, finder))
+            fprintf(stderr, "WARNING! Could not write snapshot: %s\n", snapshot_file);
+        if (S.verbosity > 0 && use_snapshot)
+            printf("|  Snapshot:             %12s                                         |\n", from_snapshot ? "loaded" : save_snapshot ? "written" : "not written");
 
 	if (S.verbosity > 0){
 		printf("|  Number of symmetries:%13d                                         |\n",S.nSymmetries());
 		printf("|  Number of invertingSyms:%10d                                         |\n",S.nInvertingSymmetries());
+		if (num_generators > 0 || group_order >= 0){
+			char order[32] = "-";
+			if (group_order >= 0) snprintf(order, sizeof(order), "10^%.2f", group_order);
+			printf("|  Group generators:     %12d                                         |\n", num_generators);
+			if (S.verbosity > 1)
+				printf("|  Group order:          %12s                                         |\n", order); }
 	}
 
         FILE* res = (argc >= 3) ? fopen(argv[2], "wb") : NULL;
 
         if (S.verbosity > 0){
             printf("|  Number of variables:  %12d                                         |\n", S.nVars());
-            printf("|  Number of clauses:    %12d                                         |\n", S.nClauses()); }
+            printf("|  Number of clauses:    %12d                                         |\n", S.nClauses());
+            if (S.nVars() > num_vars)
+                printf("|    Static breaking:    %12d auxiliary variables                     |\n", S.nVars() - num_vars); }
 
         double parsed_time = cpuTime();
         if (S.verbosity > 0){
             printf("|  Parse time:           %12.2f s                                       |\n", parsed_time - initial_time);
+            printf("|    CNF (single pass):  %12.2f s                                       |\n", cnf_parsed_time - initial_time);
+            if (cnf_parsed_mem != 0)
+                printf("|  Memory after CNF:     %12.2f MB                                      |\n", cnf_parsed_mem);
+            if (in_process && !from_snapshot){
+                printf("|  Symmetry detection:   %12.2f s %-12s                          |\n", symmetries_time - cnf_parsed_time, symmetries_complete ? "" : "(partial)");
+                if (symmetries_mem != 0)
+                    printf("|  Memory with group:    %12.2f MB                                      |\n", symmetries_mem); }
             printf("|                                                                             |\n"); }
 
         // Change to signal-handlers that will only notify the solver and allow it to terminate
@@ -183,7 +349,7 @@ int main(int argc, char** argv)
         if (res != NULL){
             if (ret == l_True){
                 fprintf(res, "s SATISFIABLE\nv ");
-                for (int i = 0; i < S.nVars(); i++)
+                for (int i = 0; i < num_vars; i++)
                     if (S.model[i] != l_Undef)
                         fprintf(res, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
                 fprintf(res, " 0\n");
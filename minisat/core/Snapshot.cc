@@ -0,0 +1,326 @@
+/*************************************************************************************[Snapshot.cc]
+Binary snapshot of a parsed problem and of its symmetries.
+
+The same license as the rest of MiniSat applies.
+**************************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "minisat/core/Dimacs.h"
+#include "minisat/core/Snapshot.h"
+#include "minisat/core/Solver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// File layout: a header, then the words of the sections in order.
+
+namespace {
+struct Header {
+    char                magic[8];
+    Snapshot::FileStamp cnf;
+    Snapshot::FileStamp sym;
+    uint32_t            finder;
+    uint32_t            sections;
+    int32_t             num_vars;
+    uint32_t            unused;
+    uint64_t            items[4];
+    uint64_t            words[4];
+    uint64_t            checksum;   // Of the words of the sections.
+};
+
+const char snapshot_magic[8] = { 'M', 'S', 'S', 'N', 'A', 'P', '3', '\n' };
+}
+
+
+Snapshot::Snapshot() : mapped(NULL), sink(NULL), num_vars(0), sections(0)
+{
+    for (int s = 0; s < num_sections; s++)
+        data[s] = NULL, items[s] = words[s] = 0;
+}
+
+
+Snapshot::~Snapshot() { delete mapped; }
+
+
+// The content is hashed 64 bits at a time, the last partial word padded with zeros: the size is
+// mixed in last, so that the padding cannot collide with actual zeros.
+Snapshot::FileStamp Snapshot::FileStamp::of(const char* filename)
+{
+    FileStamp stamp = { 0, 0 };
+    int       fd    = open(filename, O_RDONLY);
+    if (fd < 0) return stamp;
+
+    static const size_t buf_size = 1 << 16;
+    uint64_t  buf[buf_size / sizeof(uint64_t)];
+    uint64_t  h    = UINT64_C(0x9E3779B97F4A7C15);
+    uint64_t  size = 0;
+    ssize_t   n    = 0;
+    for (;;){
+        // Whole buffers but the last, whatever 'read' returns at once:
+        size_t filled = 0;
+        while (filled < buf_size && (n = read(fd, (char*)buf + filled, buf_size - filled)) > 0)
+            filled += n;
+        if (n < 0 || filled == 0) break;
+        if (filled % sizeof(uint64_t) != 0)
+            memset((char*)buf + filled, 0, sizeof(uint64_t) - filled % sizeof(uint64_t));
+        for (size_t i = 0; i < (filled + sizeof(uint64_t) - 1) / sizeof(uint64_t); i++){
+            h  = (h ^ buf[i]) * UINT64_C(0xBF58476D1CE4E5B9);
+            h ^= h >> 31; }
+        size += filled; }
+    close(fd);
+    if (n < 0) return stamp;
+
+    h  = (h ^ size) * UINT64_C(0x94D049BB133111EB);
+    h ^= h >> 29;
+    stamp.size = size;
+    stamp.hash = h;
+    return stamp;
+}
+
+
+bool Snapshot::load(const char* filename, const FileStamp& cnf, const FileStamp& sym, int finder, int needed)
+{
+    MappedBuffer* file = new MappedBuffer(filename);
+    size_t        size = file->mapped() ? file->limit() - file->cursor() : 0;
+    const Header* head = (const Header*)file->cursor();
+
+    // The sizes are checked one by one, so that a corrupt header cannot overflow their sum:
+    bool     fits  = size >= sizeof(Header);
+    uint64_t total = 0;
+    for (int s = 0; fits && s < num_sections; s++){
+        fits   = head->words[s] <= (size - sizeof(Header)) / sizeof(uint32_t) - total;
+        total += fits ? head->words[s] : 0; }
+
+    if (!fits || total * sizeof(uint32_t) != size - sizeof(Header)
+        || memcmp(head->magic, snapshot_magic, sizeof(snapshot_magic)) != 0
+        || !(head->cnf == cnf) || !(head->sym == sym) || (int)head->finder != finder
+        || (head->sections & needed) != (unsigned)needed || head->num_vars < 0){
+        delete file;
+        return false; }
+
+    const uint32_t* p = (const uint32_t*)(file->cursor() + sizeof(Header));
+    for (int s = 0; s < num_sections; s++){
+        data[s]  = p;
+        items[s] = head->items[s];
+        words[s] = head->words[s];
+        p       += head->words[s]; }
+    num_vars = head->num_vars;
+    sections = head->sections;
+    mapped   = file;
+
+    if (checksum() != head->checksum || !validate()){
+        mapped = NULL;
+        for (int s = 0; s < num_sections; s++)
+            data[s] = NULL, items[s] = words[s] = 0;
+        num_vars = sections = 0;
+        delete file;
+        return false; }
+    return true;
+}
+
+
+bool Snapshot::save(const char* filename, const FileStamp& cnf, const FileStamp& sym, int finder) const
+{
+    assert(mapped == NULL);
+    FILE* f = fopen(filename, "wb");
+    if (f == NULL) return false;
+
+    Header head;
+    memset(&head, 0, sizeof(head));
+    memcpy(head.magic, snapshot_magic, sizeof(snapshot_magic));
+    head.cnf      = cnf;
+    head.sym      = sym;
+    head.finder   = finder;
+    head.sections = sections;
+    head.num_vars = num_vars;
+    for (int s = 0; s < num_sections; s++){
+        head.items[s] = items[s];
+        head.words[s] = recorded[s].size(); }
+    head.checksum = checksum();
+
+    bool ok = fwrite(&head, sizeof(head), 1, f) == 1;
+    for (int s = 0; s < num_sections; s++)
+        if (recorded[s].size() > 0)
+            ok = ok && fwrite(begin(s), sizeof(uint32_t), recorded[s].size(), f) == (size_t)recorded[s].size();
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) ::remove(filename);
+    return ok;
+}
+
+
+//=================================================================================================
+// Recording:
+
+
+void Snapshot::addSymmetry(vec<Lit>& from, vec<Lit>& to)
+{
+    vec<uint32_t>& out = recorded[symmetries];
+    out.push(from.size());
+    for (int i = 0; i < from.size(); i++){
+        out.push(toInt(from[i]));
+        out.push(toInt(to[i])); }
+    items[symmetries]++;
+}
+
+
+void Snapshot::recordSymmetries(gzFile input_stream)
+{
+    if (input_stream != NULL)
+        parse_SYMMETRY(input_stream, *this);
+    sections |= section_symmetries;
+}
+
+
+// The stored clauses are those of 'addClause_()': sorted, without duplicate and false literals,
+// and without the satisfied clauses. Attached in the same order, they give the solver the state
+// of the parse as long as nothing was propagated: otherwise the watches were moved, and the
+// original clauses are replayed instead.
+void Snapshot::recordSolver(const Solver& S)
+{
+    if (!S.okay() || S.nAssigns() > 0 || S.nVars() != num_vars)
+        return;
+
+    vec<uint32_t>& out = recorded[solver];
+    for (int i = 0; i < S.clauses.size(); i++){
+        const Clause& c = S.ca[S.clauses[i]];
+        out.push(c.size());
+        for (int j = 0; j < c.size(); j++)
+            out.push(toInt(c[j])); }
+    items[solver] = S.clauses.size();
+    sections |= section_solver;
+}
+
+
+void Snapshot::recordGroup(const cosy::SymmetryController<Lit>& controller)
+{
+    vec<uint32_t>& out = recorded[group];
+    for (const std::unique_ptr<cosy::Permutation>& permutation : controller.group().permutations()){
+        out.push(permutation->numberOfCycles());
+        for (unsigned int c = 0; c < permutation->numberOfCycles(); c++){
+            out.push(permutation->cycle(c).size());
+            for (const cosy::Literal& element : permutation->cycle(c))
+                out.push(toInt(controller.convertFrom(element))); }
+        items[group]++; }
+    sections |= section_group;
+}
+
+
+//=================================================================================================
+// Replay:
+
+
+void Snapshot::loadClauses(Solver& S, cosy::SymmetryController<Lit>* next) const
+{
+    while (S.nVars() < num_vars) S.newVar();
+
+    const uint32_t* p = begin(clauses);
+    if (next != NULL){
+        next->reserve(num_vars, items[clauses]);
+        for (uint64_t i = 0; i < items[clauses]; i++){
+            int size = *p++;
+            next->addClause(readLits(p, size)); } }
+
+    if (sections & section_solver){
+        const uint32_t* q = begin(solver);
+        for (uint64_t i = 0; i < items[solver]; i++){
+            int  size = *q++;
+            CRef cr   = S.ca.alloc(readLits(q, size), false, false, false);
+            S.clauses.push(cr);
+            S.attachClause(cr); }
+    }else{
+        vec<Lit> lits;
+        p = begin(clauses);
+        for (uint64_t i = 0; i < items[clauses]; i++){
+            int     size   = *p++;
+            LitSpan clause = readLits(p, size);
+            lits.clear();
+            for (int j = 0; j < clause.size(); j++)
+                lits.push(clause[j]);
+            S.addClause_(lits); }
+    }
+}
+
+
+void Snapshot::loadGroup(cosy::SymmetryController<Lit>& controller) const
+{
+    const uint32_t*                            p = begin(group);
+    std::vector<std::vector<std::vector<Lit>>> generators(items[group]);
+    for (std::vector<std::vector<Lit>>& cycles : generators){
+        cycles.resize(*p++);
+        for (std::vector<Lit>& cycle : cycles){
+            int     size = *p++;
+            LitSpan lits = readLits(p, size);
+            cycle.assign(lits.lits, lits.lits + lits.size()); } }
+    controller.loadSymmetries(generators);
+}
+
+
+void Snapshot::loadSymmetries(Solver& S) const
+{
+    const uint32_t* p = begin(symmetries);
+    vec<Lit>        from, to;
+    for (uint64_t i = 0; i < items[symmetries]; i++){
+        int size = *p++;
+        from.clear(); to.clear();
+        for (int j = 0; j < size; j++){
+            from.push(toLit(*p++));
+            to  .push(toLit(*p++)); }
+        S.addSymmetry(from, to); }
+}
+
+
+//=================================================================================================
+// Helpers:
+
+
+const uint32_t* Snapshot::begin(int s) const
+{
+    if (mapped != NULL)          return data[s];
+    if (recorded[s].size() == 0) return NULL;
+    return &recorded[s][0];
+}
+
+
+uint64_t Snapshot::checksum() const
+{
+    uint64_t h = UINT64_C(0x9E3779B97F4A7C15);
+    for (int s = 0; s < num_sections; s++){
+        const uint32_t* p = begin(s);
+        uint64_t        n = mapped != NULL ? words[s] : recorded[s].size();
+        for (uint64_t i = 0; i < n; i++)
+            h = (h ^ p[i]) * UINT64_C(0x100000001B3);
+        h = (h ^ n) * UINT64_C(0xBF58476D1CE4E5B9); }
+    return h;
+}
+
+
+// Checks that each section holds exactly its items, and that their literals are variables of the
+// snapshot: the replay then reads the sections without checks.
+bool Snapshot::validate() const
+{
+    const uint32_t max_lit = 2 * (uint32_t)num_vars;
+    for (int s = 0; s < num_sections; s++){
+        const uint32_t* p   = data[s];
+        const uint32_t* end = data[s] + words[s];
+        for (uint64_t i = 0; i < items[s]; i++){
+            // Runs of literals in the item: one for a clause, one per cycle for a generator,
+            // one of pairs for a symmetry.
+            uint32_t runs = 1;
+            if (s == group){
+                if (p == end) return false;
+                runs = *p++; }
+            for (uint32_t r = 0; r < runs; r++){
+                if (p == end) return false;
+                uint64_t n = *p++;
+                if (s == symmetries)                 n *= 2;
+                if (s == solver && n < 2)            return false;
+                if (n > (uint64_t)(end - p))         return false;
+                for (const uint32_t* q = p + n; p < q; p++)
+                    if (*p >= max_lit)               return false; } }
+        if (p != end) return false; }
+    return true;
+}
@@ -0,0 +1,127 @@
+/**************************************************************************************[Snapshot.h]
+Binary snapshot of a parsed problem and of its symmetries, to restart on an instance without
+parsing its DIMACS and symmetry files or searching its symmetries again.
+
+The same license as the rest of MiniSat applies.
+**************************************************************************************************/
+
+#ifndef Minisat_Snapshot_h
+#define Minisat_Snapshot_h
+
+#include "minisat/mtl/Vec.h"
+#include "minisat/utils/ParseUtils.h"
+#include "minisat/core/SolverTypes.h"
+#include "cosy/SymmetryController.h"
+
+namespace Minisat {
+
+class Solver;
+
+//=================================================================================================
+// Snapshot -- the original clauses, the clauses as the solver stores them, the generators of the
+// cosy group and the symmetries of the symmetry file, as arrays of 32-bit 'toInt(Lit)' words. A
+// snapshot is keyed by the size and a hash of the content of the CNF and symmetry files, so that a
+// stale snapshot is detected, and rewritten, whatever their modification times. Hashing a file is
+// one sequential read of it, far cheaper than its parse.
+//
+// The clauses and symmetries are recorded while they are read (the snapshot is a clause sink for
+// 'parse_DIMACS' and a symmetry sink for 'parse_SYMMETRY'), and the clauses of the solver once the
+// CNF is read. A loaded snapshot is used in place: its arrays are given to the solver and to cosy
+// without decoding, and the clauses of the solver are attached without 'addClause_()'. Its whole
+// content is checked by 'load()', against a checksum and for its structure, so that a truncated
+// or corrupt snapshot is rewritten instead of being replayed.
+
+class Snapshot {
+public:
+    enum { section_clauses = 1, section_group = 2, section_symmetries = 4, section_solver = 8 };
+
+    // Size and content hash of a file, all 0 if it cannot be read. The sizes are compared first,
+    // as a precheck only: the hashes decide.
+    struct FileStamp {
+        uint64_t size;
+        uint64_t hash;
+        static FileStamp of(const char* filename);
+        bool operator==(const FileStamp& other) const {
+            return size == other.size && hash == other.hash; }
+    };
+
+    Snapshot();
+    ~Snapshot();
+
+    // Maps 'filename' if it is a valid snapshot of the input files stamped 'cnf' and 'sym', made
+    // with the symmetry finder 'finder', holding at least the sections 'needed'.
+    bool load(const char* filename, const FileStamp& cnf, const FileStamp& sym, int finder, int needed);
+    bool save(const char* filename, const FileStamp& cnf, const FileStamp& sym, int finder) const;
+
+    // Recording: the clauses given to 'addClause' are forwarded to 'next' (if not NULL).
+    void recordClauses   (cosy::SymmetryController<Lit>* next) { sink = next; sections |= section_clauses; }
+    void recordSolver    (const Solver& S);          // Once the CNF is read, before any other clause.
+    void recordGroup     (const cosy::SymmetryController<Lit>& controller);
+    void recordSymmetries(gzFile input_stream);   // The symmetry file, if open.
+
+    void reserve    (int vars, int clauses) { if (sink != NULL) sink->reserve(vars, clauses); }
+    template<class Lits>
+    void addClause  (const Lits& lits);
+    void addSymmetry(vec<Lit>& from, vec<Lit>& to);
+    int  nVars      () const { return num_vars; }
+
+    // Replay, of a loaded or recorded snapshot:
+    void loadClauses   (Solver& S, cosy::SymmetryController<Lit>* next) const;
+    void loadGroup     (cosy::SymmetryController<Lit>& controller) const;
+    void loadSymmetries(Solver& S) const;
+
+private:
+    // A run of literals of a section, read in place.
+    struct LitSpan {
+        const Lit* lits;
+        int        n;
+        int        size      ()      const { return n; }
+        Lit        operator[](int i) const { return lits[i]; }
+    };
+
+    MappedBuffer*                  mapped;
+    cosy::SymmetryController<Lit>* sink;
+    int                            num_vars;
+    int                            sections;
+
+    // Section contents, in 'mapped' when loaded and in 'recorded' otherwise:
+    enum { clauses = 0, solver = 1, group = 2, symmetries = 3, num_sections = 4 };
+    vec<uint32_t>   recorded[num_sections];
+    const uint32_t* data    [num_sections];
+    uint64_t        items   [num_sections];
+    uint64_t        words   [num_sections];
+
+    const uint32_t* begin     (int s) const;
+    uint64_t        checksum  () const;
+    bool            validate  () const;
+    static LitSpan  readLits  (const uint32_t*& in, int n) { LitSpan l = { (const Lit*)in, n }; in += n; return l; }
+    template<class Lits>
+    static void     writeLits (vec<uint32_t>& out, const Lits& lits);
+};
+
+
+//=================================================================================================
+// Implementation of template methods:
+
+template<class Lits>
+inline void Snapshot::writeLits(vec<uint32_t>& out, const Lits& lits)
+{
+    out.push(lits.size());
+    for (int i = 0; i < lits.size(); i++)
+        out.push(toInt(lits[i]));
+}
+
+template<class Lits>
+inline void Snapshot::addClause(const Lits& lits)
+{
+    writeLits(recorded[clauses], lits);
+    for (int i = 0; i < lits.size(); i++)
+        if (var(lits[i]) >= num_vars) num_vars = var(lits[i]) + 1;
+    items[clauses]++;
+    if (sink != NULL) sink->addClause(lits);
+}
+
+//=================================================================================================
+}
+
+#endif
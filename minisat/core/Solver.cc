@@ -54,6 +54,8 @@ static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction o
 static BoolOption    opt_storing	       (_cat, "storing",     "Store generated symmetry clauses for future use", true);
 static BoolOption    opt_inverting	       (_cat, "inverting-opt","Adjust initial variable order to make inverting symmetries faster", false);
 static BoolOption    opt_inactive	       (_cat, "inactive-opt","Conduct symmetry propagation for inactive symmetries", false);
+static IntOption     opt_stab_mode         (_cat, "stab-mode",   "Stabilizers of symmetry clauses (0=exact, 1=capped)", 0, IntRange(0, 1));
+static IntOption     opt_stab_cap          (_cat, "stab-cap",    "In stab-mode 1, symmetries moving clause literals tested per clause", 64, IntRange(0, INT32_MAX));
 
 // static BoolOption    opt_esbp_begin	       (_cat, "esbp-begin","Conduct symmetry propagation for inactive symmetries", false);
 static BoolOption    opt_esbp_end	       (_cat, "esbp-end","Conduct symmetry propagation for inactive symmetries", true);
@@ -95,14 +97,19 @@ Solver::Solver() :
   , addConflictClauses				(opt_storing)
   , varOrderOptimization			(opt_inverting)
   , inactivePropagationOptimization	(opt_inactive)
+  , stab_mode                       (opt_stab_mode)
+  , stab_cap                        (opt_stab_cap)
 
     // Statistics: (formerly in 'SolverStats')
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0)
   , dec_vars(0), num_clauses(0), num_learnts(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
   , sympropagations(0), symconflicts(0), invertingSyms(0)
+  , symqueue_visits(0), symqueue_skips(0)
+  , stab_found(0), stab_dropped(0), stab_calls(0), stab_time(0)
 
   , watches            (WatcherDeleted(ca))
+  , watches_bin        (WatcherDeleted(ca))
   , order_heap         (VarOrderLt(activity))
 
   , ok                 (true)
@@ -113,6 +120,7 @@ Solver::Solver() :
   , simpDB_props       (0)
   , progress_estimate  (0)
   , remove_satisfied   (true)
+  , static_breaking    (false)
   , next_var           (0)
 
     // Resource constraints:
@@ -120,6 +128,9 @@ Solver::Solver() :
   , conflict_budget    (-1)
   , propagation_budget (-1)
   , asynch_interrupt   (false)
+
+  , sym_queue          (SymQueueLt())
+  , lit_stamp_time     (0)
 {}
 
 
@@ -146,8 +157,11 @@ Var Solver::newVar(lbool upol, bool dvar)
 
     watches  .init(mkLit(v, false));
     watches  .init(mkLit(v, true ));
+    watches_bin.init(mkLit(v, false));
+    watches_bin.init(mkLit(v, true ));
     assigns  .insert(v, l_Undef);
     vardata  .insert(v, mkVarData(CRef_Undef, 0));
+    symmetry_unit.insert(v, 0);
     activity .insert(v, rnd_init_act ? drand(random_seed) * 0.00001 : 0);
     seen     .insert(v, 0);
     polarity .insert(v, true);
@@ -158,6 +172,8 @@ Var Solver::newVar(lbool upol, bool dvar)
 	decisionVars.push(false);
 	watcherSymmetries.push();
 	watcherSymmetries.push();
+    lit_stamp.push(0);
+    lit_stamp.push(0);
     return v;
 }
 
@@ -206,8 +222,9 @@ bool Solver::addClause_(vec<Lit>& ps)
 void Solver::attachClause(CRef cr){
     const Clause& c = ca[cr];
     assert(c.size() > 1);
-    watches[~c[0]].push(Watcher(cr, c[1]));
-    watches[~c[1]].push(Watcher(cr, c[0]));
+    OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>& ws = c.size() == 2 ? watches_bin : watches;
+    ws[~c[0]].push(Watcher(cr, c[1]));
+    ws[~c[1]].push(Watcher(cr, c[0]));
     if (c.learnt()) num_learnts++, learnts_literals += c.size();
     else            num_clauses++, clauses_literals += c.size();
 }
@@ -217,13 +234,15 @@ void Solver::detachClause(CRef cr, bool strict){
     const Clause& c = ca[cr];
     assert(c.size() > 1);
 
+    OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>& ws = c.size() == 2 ? watches_bin : watches;
+
     // Strict or lazy detaching:
     if (strict){
-        remove(watches[~c[0]], Watcher(cr, c[1]));
-        remove(watches[~c[1]], Watcher(cr, c[0]));
+        remove(ws[~c[0]], Watcher(cr, c[1]));
+        remove(ws[~c[1]], Watcher(cr, c[0]));
     }else{
-        watches.smudge(~c[0]);
-        watches.smudge(~c[1]);
+        ws.smudge(~c[0]);
+        ws.smudge(~c[1]);
     }
 
     if (c.learnt()) num_learnts--, learnts_literals -= c.size();
@@ -273,17 +292,30 @@ void Solver::cancelUntil(int level) {
         qhead = trail_lim[level];
         trail.shrink(trail.size() - trail_lim[level]);
         trail_lim.shrink(trail_lim.size() - level);
+        if (symmetry != nullptr)
+            symmetry->cancelUntil(level);
 
     }
 
 
 }
 
-void Solver::addSymmetry(vec<Lit>& from, vec<Lit>& to){
+void Solver::addSymmetry(vec<Lit>& from, vec<Lit>& to,
+		std::shared_ptr<const cosy::PermutationTable<cosy::Literal>> table){
 	assert(from.size()==to.size());
-	Symmetry* sym = new Symmetry(this, from, to, symmetries.size());
+	if(table == nullptr){
+		std::shared_ptr<cosy::PermutationTable<cosy::Literal>> own(new cosy::PermutationTable<cosy::Literal>());
+		for(int i=0; i<from.size(); ++i)
+			if(from[i]!=to[i])
+				own->add(toCosy(from[i]),toCosy(to[i]));
+		own->build();
+		table = own;
+	}
+	Symmetry* sym = new Symmetry(this, table, symmetries.size());
 	bool isInverting = false;
 	symmetries.push(sym);
+	sym->markPending();
+	ca.compatSets().growTo(symmetries.size());
 	for(int i=0; i<from.size(); ++i){
 		assert(from[i]!=to[i]);
 		watcherSymmetries[toInt(from[i])].push(sym);
@@ -307,13 +339,12 @@ CRef Solver::propagateSymmetrical(Symmetry* sym, Lit l){
 	assert(value(sym->getSymmetrical(l))!=l_True);
         bool isSymmetry = false;
         bool isFirstSymmetry = false;
-        std::set<Symmetry*> comp;
 
 	++sympropagations; //note: every symmetrical propagation either induces a conflict, or will be examined in the propagation queue (see the counter propagations)
 
 	implic.clear();
 	if(level(var(l))==0){
-            assert(symmetry_units.find(var(l)) == symmetry_units.end());
+            assert(!isSymmetryUnit(var(l)));
             implic.push(sym->getSymmetrical(l));
             implic.push(~l);
 	}else{
@@ -329,11 +360,10 @@ CRef Solver::propagateSymmetrical(Symmetry* sym, Lit l){
 	assert(value(implic[0])!=l_True);
 	assert(value(implic[1])==l_False);
 
-        std::unique_ptr<std::set<Symmetry*>> compatibility = isSymmetry ?
-            std::unique_ptr<std::set<Symmetry*>>(new std::set<Symmetry*>(ca[reason(var(l))].scompat()->begin(), ca[reason(var(l))].scompat()->end())) :
-            nullptr;
+        // The symmetrical clause shares the compatible symmetries of the reason:
+        CompatRef compatibility = isSymmetry ? ca[reason(var(l))].compat() : CompatRef_Empty;
 
-	CRef cr = ca.alloc(implic, true, isFirstSymmetry, isSymmetry, std::move(compatibility));
+	CRef cr = ca.alloc(implic, true, isFirstSymmetry, isSymmetry, compatibility);
 	if(verbosity>=2){ printf("Symmetry clause added: "); testPrintClauseDimacs(cr); }
 	if(value(implic[0])==l_Undef){
 		assert( testPropagationClause(sym,l,implic) );
@@ -390,7 +420,7 @@ void Solver::notifySymmetries(Lit p){
                 l = clause[j];
                 for(int i=watcherSymmetries[toInt(l)].size()-1; i>=0 ; --i) {
                     if (watcherSymmetries[toInt(l)][i]->isStab() &&
-                        (*ca[cr].scompat()).find(watcherSymmetries[toInt(l)][i]) == (*ca[cr].scompat()).end())
+                        !ca.compatSets().has(clause.compat(), watcherSymmetries[toInt(l)][i]->getId()))
                         watcherSymmetries[toInt(l)][i]->notifyReasonOfBreaked(p);
                 }
             }
@@ -627,7 +657,7 @@ Lit Solver::pickBranchLit()
 |        rest of literals. There may be others from the same level though.
 |
 |________________________________________________________________________________________________@*/
-void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, bool &out_symmetry, std::set<Symmetry*>* comp)
+void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, bool &out_symmetry, vec<uint64_t>& comp)
 {
     int pathC = 0;
     Lit p     = lit_Undef;
@@ -656,7 +686,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, bool &o
         for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
             Lit q = c[j];
 
-            if (level(var(q)) == 0 && symmetry_units.find(var(q)) != symmetry_units.end())
+            if (level(var(q)) == 0 && isSymmetryUnit(var(q)))
                 out_symmetry = true;
 
             if (!seen[var(q)] && level(var(q)) > 0){
@@ -733,48 +763,78 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, bool &o
     if (!out_symmetry)
         return;
 
-    comp->clear();
+    // Intersection of the compatible symmetries of the symmetry clauses used:
+    const CompatSets& compat_sets = ca.compatSets();
+    compat_sets.clearSet(comp);
     if (out_symmetry && !fsym) {
+        bool first = true;
         for (CRef cr : conf_clauses) {
-            std::set<Symmetry*>* check = ca[cr].scompat();
-            if (check->empty()) {
-                comp->clear();
+            const uint64_t* check = compat_sets[ca[cr].compat()];
+            uint64_t any = 0;
+            for (int w = 0; w < comp.size(); w++){
+                comp[w] = first ? check[w] : comp[w] & check[w];
+                any |= comp[w]; }
+            first = false;
+
+            if (any == 0)
                 break;
-            }
+        }
+    }
 
-            if (comp->empty()) {
-                comp->insert(check->begin(), check->end());
-                continue;
-            }
+    addStabilizers(out_learnt, comp);
+}
 
-            // make intersection with c in place on comp
-            std::set<Symmetry*>::iterator it1 = comp->begin();
-            std::set<Symmetry*>::iterator it2 = check->begin();
-            while ( (it1 != comp->end()) && (it2 != check->end()) ) {
-                if (*it1 < *it2) {
-                    comp->erase(it1++);
-                } else if (*it2 < *it1) {
-                    ++it2;
-                } else { // *it1 == *it2
-                    ++it1;
-                    ++it2;
-                }
-            }
-            comp->erase(it1, comp->end());
 
-            if (comp->empty())
-                break;
+// A symmetry maps 'clause' onto itself iff each clause literal it moves has its image in the
+// clause. With the clause stamped, only the pairs (literal, symmetry moving it) given by
+// 'watcherSymmetries' are checked, in one pass; the other symmetries fix the clause.
+//   In mode 1, past 'stab_cap' symmetries met this way, the next ones are dropped without
+// test. Only one call in 'stab_sample' is timed, to keep 'cpuTime()' off the conflict path.
+template<class Lits>
+void Solver::addStabilizers(const Lits& clause, vec<uint64_t>& comp)
+{
+    // An empty 'comp' (a pool without symmetry ids) is no restriction, there is nothing to add to it.
+    int n_words = (symmetries.size() + 63) >> 6;
+    if (symmetries.size() == 0 || comp.size() == 0)
+        return;
+    assert(comp.size() == n_words);
+
+    bool   timed = stab_calls++ % stab_sample == 0;
+    double start = timed ? cpuTime() : 0;
+    stab_ids.clear();
+    stampLits(clause);
+
+    stab_ids.growTo(n_words, ~(uint64_t)0);
+    if (symmetries.size() & 63)
+        stab_ids[n_words - 1] = ((uint64_t)1 << (symmetries.size() & 63)) - 1;
+
+    int tested = 0;
+    if (stab_mode == 1){
+        stab_tested.clear();
+        stab_tested.growTo(n_words, 0); }
+
+    for (int i = 0; i < (int)clause.size(); i++){
+        Lit p = clause[i];
+        const vec<Symmetry*>& syms = watcherSymmetries[toInt(p)];
+        for (int k = 0; k < syms.size(); k++){
+            int id = syms[k]->getId();
+            if (stab_mode == 1 && !CompatSets::hasId(stab_tested, id)){
+                CompatSets::addId(stab_tested, id);
+                if (++tested > stab_cap){
+                    stab_dropped += CompatSets::hasId(stab_ids, id);
+                    stab_ids[id >> 6] &= ~((uint64_t)1 << (id & 63));
+                    continue; }
+            }
+            if (!isStamped(syms[k]->getSymmetrical(p)))
+                stab_ids[id >> 6] &= ~((uint64_t)1 << (id & 63));
         }
     }
 
-    for (int i=symmetries.size()-1; i>=0; --i) {
-        Symmetry* sym = symmetries[i];
-        if(comp->find(sym) != comp->end())
-            continue;
-
-        if (sym->stabilize(out_learnt))
-            comp->insert(sym);
-    }
+    for (int w = 0; w < n_words; w++){
+        stab_found += __builtin_popcountll(stab_ids[w] & ~comp[w]);
+        comp[w] |= stab_ids[w]; }
+    if (timed)
+        stab_time += cpuTime() - start;
 }
 
 
@@ -904,6 +964,8 @@ CRef Solver::propagate()
     CRef    confl     = CRef_Undef;
     int     num_props = 0;
     bool isSymmetryLevelZero;
+    // With the static breaking, a unit at level 0 from a symmetry clause is a symmetry unit:
+    const bool symmetry_clause_units = decisionLevel() == 0 && static_breaking;
 
     while (qhead < trail.size()){
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
@@ -913,8 +975,7 @@ CRef Solver::propagate()
 
         if(verbosity>=2){ printf("Prop %i: %i\n",decisionLevel(),toDimacs(p)); }
 
-        isSymmetryLevelZero = (decisionLevel() == 0 &&
-                               symmetry_units.find(var(p)) != symmetry_units.end());
+        isSymmetryLevelZero = (decisionLevel() == 0 && isSymmetryUnit(var(p)));
 
         // if (symmetry != nullptr && opt_esbp_begin) {
         //     symmetry->updateNotify(p);
@@ -924,7 +985,30 @@ CRef Solver::propagate()
         // }
         // learntSymmetryClause(cosy::ClauseInjector::ESBP_FORCING, p);
 
-        for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+        // Binary clauses first: the blocker is the implied literal, so the clause is only
+        // read to put that literal at data[0], where 'analyze()' expects the reason's literal.
+        vec<Watcher>&  wbin  = watches_bin.lookup(p);
+        for (int k = 0; k < wbin.size(); k++){
+            Lit imp = wbin[k].blocker;
+            if (value(imp) == l_True)
+                continue;
+
+            CRef cr = wbin[k].cref;
+            if (value(imp) == l_False){
+                confl = cr;
+                qhead = trail.size();
+                break; }
+
+            Clause& c = ca[cr];
+            if (c[0] != imp)
+                c[1] = c[0], c[0] = imp;
+            if (isSymmetryLevelZero || (symmetry_clause_units && c.symmetry()))
+                setSymmetryUnit(var(imp));
+            uncheckedEnqueue(imp, cr);
+        }
+
+        // On a binary conflict the long clauses are left untouched ('end' == 'i'):
+        for (i = j = (Watcher*)ws, end = i + (confl == CRef_Undef ? ws.size() : 0);  i != end;){
             // Try to avoid inspecting the clause:
             Lit blocker = i->blocker;
             if (value(blocker) == l_True){
@@ -961,8 +1045,8 @@ CRef Solver::propagate()
                 while (i < end)
                     *j++ = *i++;
             }else {
-                if (isSymmetryLevelZero)
-                    symmetry_units.insert(var(first));
+                if (isSymmetryLevelZero || (symmetry_clause_units && c.symmetry()))
+                    setSymmetryUnit(var(first));
 
                 uncheckedEnqueue(first, cr);
                 // if (symmetry != nullptr && symmetry->hasClauseToInject(cosy::ClauseInjector::ESBP, first)) {
@@ -979,27 +1063,40 @@ CRef Solver::propagate()
             learntSymmetryClause(cosy::ClauseInjector::ESBP, p);
         }
 
-		// weakly active symmetry propagation: the condition qhead==trail.size() makes sure symmetry propagation is executed after unit propagation
-		for( int i=symmetries.size()-1; qhead==trail.size() && confl==CRef_Undef && i>=0; --i){
-			Symmetry* sym = symmetries[i];
-			Lit orig = lit_Undef;
-			if(sym->isActive()){
-				orig = sym->getNextToPropagate();
-				if(orig!=lit_Undef){
-					confl = propagateSymmetrical(sym,orig);
+		// weakly active symmetry propagation: the condition qhead==trail.size() makes sure symmetry propagation is executed after unit propagation.
+		// Only the queued symmetries are visited, in decreasing id order; the others have nothing to propagate.
+		if(qhead==trail.size() && confl==CRef_Undef && !sym_queue.empty()){
+			int visited = 0;
+			sym_delayed.clear();
+			while(qhead==trail.size() && confl==CRef_Undef && !sym_queue.empty()){
+				Symmetry* sym = symmetries[sym_queue.removeMin()];
+				++visited;
+				if(sym->isActive()){
+					Lit orig = sym->getNextToPropagate();
+					if(orig!=lit_Undef){
+						confl = propagateSymmetrical(sym,orig);
+						sym->markPending();
+					}
+				}else if(inactivePropagationOptimization && sym->isStab() && sym->isStabLevelZero()){
+					sym_delayed.push(sym);
 				}
 			}
-		}
 
-		// weakly inactive symmetry propagation: the condition qhead==trail.size() makes sure symmetry propagation is executed after unit propagation
-		for( int i=symmetries.size()-1; inactivePropagationOptimization && qhead==trail.size() && confl==CRef_Undef && i>=0; --i){
-			Symmetry* sym = symmetries[i];
-                        if (!sym->isActive() && sym->isStab() && sym->isStabLevelZero()) {
-				Lit orig = sym->getNextToPropagate();
-				if(orig!=lit_Undef){
+			// weakly inactive symmetry propagation, only when no active symmetry propagated:
+			for(int i=0; i<sym_delayed.size(); ++i){
+				Symmetry* sym = sym_delayed[i];
+				if(qhead==trail.size() && confl==CRef_Undef){
+					Lit orig = sym->getNextToPropagate();
+					if(orig==lit_Undef){
+						continue;
+					}
 					confl = propagateSymmetrical(sym,orig);
 				}
+				sym->markPending();
 			}
+
+			symqueue_visits += visited;
+			symqueue_skips  += symmetries.size() - visited;
 		}
 
                 // if (qhead == trail.size()) {
@@ -1077,11 +1174,21 @@ void Solver::removeSatisfied(vec<CRef>& cs)
         else{
             // Trim clause:
             // assert(value(c[0]) == l_Undef && value(c[1]) == l_Undef);
+            // The watch list of a clause follows from its size: a clause trimmed down to two
+            // literals is moved to the binary watches, the others stay where they are.
+            int trimmed = 0;
+            for (int k = 2; k < c.size(); k++)
+                trimmed += value(c[k]) == l_False;
+            bool to_bin = c.size() > 2 && c.size() - trimmed == 2;
+            if (to_bin) detachClause(cs[i], true);
             for (int k = 2; k < c.size(); k++)
                 if (value(c[k]) == l_False){
                     c[k--] = c[c.size()-1];
                     c.pop();
                 }
+            if (to_bin)              attachClause(cs[i]);
+            else if (c.learnt())     learnts_literals -= trimmed;
+            else                     clauses_literals -= trimmed;
             cs[j++] = cs[i];
         }
     }
@@ -1185,24 +1292,23 @@ lbool Solver::search(int nof_conflicts)
             if (decisionLevel() == 0) return l_False;
 
             // current_level = decisionLevel();
-            std::set<Symmetry*> comp;
             learnt_clause.clear();
-            analyze(confl, learnt_clause, backtrack_level, tag_symmetry, &comp);
+            analyze(confl, learnt_clause, backtrack_level, tag_symmetry, analyze_compat);
             cancelUntil(backtrack_level);
 
 
             if (learnt_clause.size() == 1){
                 assert(decisionLevel() == 0);
                 if (tag_symmetry)
-                    symmetry_units.insert(var(learnt_clause[0]));
+                    setSymmetryUnit(var(learnt_clause[0]));
 
                 uncheckedEnqueue(learnt_clause[0]);
             } else {
                 bool first_symmetry = ca[confl].fsymmetry();
                 assert(!first_symmetry || tag_symmetry);
 
-                std::unique_ptr<std::set<Symmetry*>> compatibility = tag_symmetry ? std::unique_ptr<std::set<Symmetry*>>(new std::set<Symmetry*>(comp.begin(), comp.end())) : nullptr;
-                CRef cr = ca.alloc(learnt_clause, true, first_symmetry, tag_symmetry, std::move(compatibility));
+                CompatRef compatibility = tag_symmetry ? ca.compatSets().intern(analyze_compat) : CompatRef_Empty;
+                CRef cr = ca.alloc(learnt_clause, true, first_symmetry, tag_symmetry, compatibility);
                 // if (first_symmetry) {
                 //     conflictC--;
                 //     // setRandomPolarity(ca[cr]);
@@ -1345,10 +1451,10 @@ lbool Solver::solve_()
     if (symmetry != nullptr) {
         cosy::ClauseInjector::Type type = cosy::ClauseInjector::UNITS;
 	while (symmetry->hasClauseToInject(type)) {
-            std::vector<Lit> literals = symmetry->clauseToInject(type);
-            assert(literals.size() == 1);
-            Lit l = literals[0];
-            symmetry_units.insert(var(l));
+            symmetry->clauseToInject(type, &symmetry_clause);
+            assert(symmetry_clause.size() == 1);
+            Lit l = symmetry_clause[0];
+            setSymmetryUnit(var(l));
 	    uncheckedEnqueue(l);
 	}
     }
@@ -1388,7 +1494,7 @@ lbool Solver::solve_()
         //             assert(literals.size() == 1);
         //             Lit l = literals[0];
         //             if (value(l) == l_Undef) {
-        //                 symmetry_units.insert(var(l));
+        //                 setSymmetryUnit(var(l));
         //                 uncheckedEnqueue(l);
         //             }
         //         }
@@ -1428,7 +1534,7 @@ lbool Solver::solve_()
 
 bool Solver::implies(const vec<Lit>& assumps, vec<Lit>& out)
 {
-    trail_lim.push(trail.size());
+    newDecisionLevel();
     for (int i = 0; i < assumps.size(); i++){
         Lit a = assumps[i];
 
@@ -1540,6 +1646,8 @@ void Solver::printStats() const
     printf("decisions             : %-12" PRIu64"   (%4.2f %% random) (%.0f /sec)\n", decisions, (float)rnd_decisions*100 / (float)decisions, decisions   /cpu_time);
     printf("propagations          : %-12" PRIu64"   (%.0f /sec)\n", propagations, propagations/cpu_time);
     printf("sympropagations       : %-12" PRIu64"   (%.0f /sec)\n", sympropagations, sympropagations/cpu_time);
+    printf("symmetries visited    : %-12" PRIu64"   (%4.2f %% skipped)\n", symqueue_visits, symqueue_skips*100 / (double)(symqueue_visits + symqueue_skips));
+    printf("stabilizers found     : %-12" PRIu64"   (%" PRIu64" dropped by the cap, ~%.2f s)\n", stab_found, stab_dropped, stab_time * stab_sample);
     printf("conflict literals     : %-12" PRIu64"   (%4.2f %% deleted)\n", tot_literals, (max_literals - tot_literals)*100 / (double)max_literals);
     if (mem_used != 0) printf("Memory used           : %.2f MB\n", mem_used);
 
@@ -1561,12 +1669,16 @@ void Solver::relocAll(ClauseAllocator& to)
     // All watchers:
     //
     watches.cleanAll();
+    watches_bin.cleanAll();
     for (int v = 0; v < nVars(); v++)
         for (int s = 0; s < 2; s++){
             Lit p = mkLit(v, s);
             vec<Watcher>& ws = watches[p];
             for (int j = 0; j < ws.size(); j++)
                 ca.reloc(ws[j].cref, to);
+            vec<Watcher>& wbin = watches_bin[p];
+            for (int j = 0; j < wbin.size(); j++)
+                ca.reloc(wbin[j].cref, to);
         }
 
     // All reasons:
@@ -1619,24 +1731,14 @@ void Solver::garbageCollect()
 CRef Solver::learntSymmetryClause(cosy::ClauseInjector::Type type, Lit p) {
     if (symmetry != nullptr) {
         if (symmetry->hasClauseToInject(type, p)) {
-            std::vector<Lit> vsbp = symmetry->clauseToInject(type, p);
-
-            // Dirty make a copy of vector
-            vec<Lit> sbp;
-            for (Lit l : vsbp) {
-                assert(value(l) == l_False);
-                sbp.push(l);
-            }
-
-            std::set<Symmetry*>comp;
-            for( int i=symmetries.size()-1; i>=0; --i){
-                Symmetry* sym = symmetries[i];
-                if(sym->stabilize(sbp)){
-                    comp.insert (sym);
-                }
-	    }
-            std::unique_ptr<std::set<Symmetry*>> compatibility(new std::set<Symmetry*>(comp.begin(), comp.end()));
-            CRef cr = ca.alloc(sbp, true, true, true, std::move(compatibility));
+            std::vector<Lit>& sbp = symmetry_clause;
+            symmetry->clauseToInject(type, p, &sbp);
+            for (int i = 0; i < (int)sbp.size(); i++)
+                assert(value(sbp[i]) == l_False);
+
+            ca.compatSets().clearSet(analyze_compat);
+            addStabilizers(sbp, analyze_compat);
+            CRef cr = ca.alloc(sbp, true, true, true, ca.compatSets().intern(analyze_compat));
             learnts.push(cr);
             attachClause(cr);
             // _stats.sizeESBP.add(sbp.size());
@@ -1652,14 +1754,10 @@ CRef Solver::learntSymmetryClause(cosy::ClauseInjector::Type type, Lit p) {
 CRef Solver::learntSymmetryClause(cosy::ClauseInjector::Type type) {
     if (symmetry != nullptr) {
         if (symmetry->hasClauseToInject(type)) {
-            std::vector<Lit> vsbp = symmetry->clauseToInject(type);
-
-            // Dirty make a copy of vector
-            vec<Lit> sbp;
-            for (Lit l : vsbp) {
-                sbp.push(l);
-                assert(value(l) == l_False);
-            }
+            std::vector<Lit>& sbp = symmetry_clause;
+            symmetry->clauseToInject(type, &sbp);
+            for (int i = 0; i < (int)sbp.size(); i++)
+                assert(value(sbp[i]) == l_False);
 
             CRef cr = ca.alloc(sbp, true, true, true);
 
@@ -1674,6 +1772,41 @@ CRef Solver::learntSymmetryClause(cosy::ClauseInjector::Type type) {
 }
 
 
+// A clause of the static symmetry breaking is simplified as by 'addClause_()', then kept with the
+// problem clauses, flagged as the ESBPs are: its compatible symmetries are those mapping it onto
+// itself, and a unit from it is a symmetry unit.
+bool Solver::addBreakingClause(vec<Lit>& ps)
+{
+    assert(decisionLevel() == 0);
+    if (!ok) return false;
+    static_breaking = true;
+
+    sort(ps);
+    Lit p; int i, j;
+    for (i = j = 0, p = lit_Undef; i < ps.size(); i++)
+        if (value(ps[i]) == l_True || ps[i] == ~p)
+            return true;
+        else if (value(ps[i]) != l_False && ps[i] != p)
+            ps[j++] = p = ps[i];
+    ps.shrink(i - j);
+
+    if (ps.size() == 0)
+        return ok = false;
+    else if (ps.size() == 1){
+        setSymmetryUnit(var(ps[0]));
+        uncheckedEnqueue(ps[0]);
+        return ok = (propagate() == CRef_Undef);
+    }else{
+        ca.compatSets().clearSet(analyze_compat);
+        addStabilizers(ps, analyze_compat);
+        CRef cr = ca.alloc(ps, false, true, true, ca.compatSets().intern(analyze_compat));
+        clauses.push(cr);
+        attachClause(cr);
+    }
+
+    return true;
+}
+
 void Solver::cleanAllSymmetricClauses() {
     assert(decisionLevel() == 0);
 
@@ -1695,7 +1828,7 @@ void Solver::cleanAllSymmetricClauses() {
     for (i = 0; i < trail.size(); i++) {
         Lit l = trail[i];
         Var x = var(l);
-        if (symmetry_units.find(x) == symmetry_units.end())
+        if (!isSymmetryUnit(x))
             real_units.push_back(l);
     }
 
@@ -1712,6 +1845,8 @@ void Solver::cleanAllSymmetricClauses() {
             symmetry->updateCancel(l);
         insertVarOrder(x);
     }
+    if (symmetry != nullptr)
+        symmetry->cancelUntil(-1);
 
     rebuildOrderHeap();
 
@@ -1721,7 +1856,8 @@ void Solver::cleanAllSymmetricClauses() {
     qhead = 0;
     trail.clear();
     trail_lim.clear();
-    symmetry_units.clear();
+    for (Var v = 0; v < nVars(); v++)
+        symmetry_unit[v] = 0;
 
     for (const Lit & l : real_units)
         uncheckedEnqueue(l);
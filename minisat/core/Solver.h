@@ -29,7 +29,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define Minisat_Solver_h
 
 #include <memory>
-#include <unordered_set>
+#include <set>
 
 #include "minisat/mtl/Vec.h"
 #include "minisat/mtl/Heap.h"
@@ -37,6 +37,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "minisat/mtl/IntMap.h"
 #include "minisat/utils/Options.h"
 #include "minisat/core/SolverTypes.h"
+#include "cosy/PermutationTable.h"
 #include "cosy/SymmetryController.h"
 
 namespace Minisat {
@@ -112,9 +113,17 @@ public:
     CRef learntSymmetryClause(cosy::ClauseInjector::Type type, Lit p);
     CRef learntSymmetryClause(cosy::ClauseInjector::Type type);
     void cleanAllSymmetricClauses();
+    bool addBreakingClause(vec<Lit>& ps);  // Add a clause of the static symmetry breaking, as a symmetry clause of the problem.
     void sortESBP(vec<Lit>& out_clause);
 
-    std::unordered_set<Var> symmetry_units;
+    bool    isSymmetryUnit (Var x) const { return symmetry_unit[x]; }  // Level 0 assignment derived from symmetry breaking?
+    void    setSymmetryUnit(Var x)       { symmetry_unit[x] = 1; }
+
+    template<class Lits>
+    void    addStabilizers (const Lits& clause, vec<uint64_t>& comp);  // Adds to 'comp' the ids of the symmetries mapping 'clause' onto itself.
+    template<class Lits>
+    void    stampLits      (const Lits& lits);                          // Marks 'lits' until the next call (see 'isStamped()').
+    bool    isStamped      (Lit p) const { return lit_stamp[toInt(p)] == lit_stamp_time; }
 
     std::vector<Lit> getVSIDSVector();
 
@@ -188,19 +197,26 @@ public:
     bool	addConflictClauses;
     bool	varOrderOptimization;
     bool	inactivePropagationOptimization;
+    int     stab_mode;          // Controls the stabilizers of symmetry clauses (0=exact, 1=capped).
+    int     stab_cap;           // In mode 1, the number of symmetries moving clause literals tested per clause.
 
     // Statistics: (read-only member variable)
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts;
 	uint64_t dec_vars, num_clauses, num_learnts, clauses_literals, learnts_literals, max_literals, tot_literals;
     uint64_t sympropagations, symconflicts, invertingSyms;
+    uint64_t symqueue_visits, symqueue_skips;
+    uint64_t stab_found, stab_dropped, stab_calls;
+    double   stab_time;          // CPU time of the 'addStabilizers()' calls sampled, one in 'stab_sample'.
+    static const int stab_sample = 64;
 
 
     void setRandomPolarity(const Clause& clause);
 
 	// Symmetry methods:
 	//
-	void	addSymmetry(vec<Lit>& from, vec<Lit>& to);	// Add a symmetry to the solver.
+	void	addSymmetry(vec<Lit>& from, vec<Lit>& to,	// Add a symmetry to the solver, sharing the lookup 'table' of
+			std::shared_ptr<const cosy::PermutationTable<cosy::Literal>> table = nullptr);	// its cosy permutation if given.
 	bool	isDecision(Lit l){return decisionVars[var(l)];}
 	void	notifySymmetries(Lit p);
         void    notifySymmetriesBacktrack(Lit p);
@@ -251,6 +267,10 @@ protected:
         VarOrderLt(const IntMap<Var, double>&  act) : activity(act) { }
     };
 
+    struct SymQueueLt {
+        bool operator () (int x, int y) const { return x > y; }  // Highest id first, as the former reverse scan over 'symmetries'.
+    };
+
     struct ShrinkStackElem {
         uint32_t i;
         Lit      l;
@@ -271,8 +291,11 @@ protected:
     VMap<lbool>         user_pol;         // The users preferred polarity of each variable.
     VMap<char>          decision;         // Declares if a variable is eligible for selection in the decision heuristic.
     VMap<VarData>       vardata;          // Stores reason and level for each variable.
+    VMap<char>          symmetry_unit;    // Marks the variables assigned at level 0 because of symmetry breaking.
     OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>
                         watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>
+                        watches_bin;      // Same for binary clauses, where the blocker is the other literal of the clause.
 
     Heap<Var,VarOrderLt>order_heap;       // A priority queue of variables ordered with respect to the variable activity.
 
@@ -284,6 +307,7 @@ protected:
     int64_t             simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplify()'.
     double              progress_estimate;// Set by 'search()'.
     bool                remove_satisfied; // Indicates whether possibly inefficient linear scan for satisfied clauses should be performed in 'simplify'.
+    bool                static_breaking;  // Are there clauses of the static symmetry breaking? Then their units at level 0 are symmetry units.
     Var                 next_var;         // Next variable to be created.
     ClauseAllocator     ca;
 
@@ -317,7 +341,7 @@ protected:
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
-    void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel, bool& out_symmetry, std::set<Symmetry*>* comp);    // (bt = backtrack)
+    void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel, bool& out_symmetry, vec<uint64_t>& comp);    // (bt = backtrack)
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p);                                                 // (helper method for 'analyze()')
     lbool    search           (int nof_conflicts);                                     // Search for a given number of conflicts.
@@ -358,7 +382,15 @@ protected:
 	vec<Symmetry*>		symmetries;		  	// List of all symmetries in the solver.
 	vec<bool>			decisionVars;		// map mapping vars to a bool which if true iff the lit is a decision lit.
 	vec<vec<Symmetry*> > watcherSymmetries; // List of symmetries which should be notified know when a certain literal  becomes true (index is lit)
+	Heap<int,SymQueueLt> sym_queue;		// Ids of the symmetries which may have a pending symmetrical propagation.
+	vec<Symmetry*>		sym_delayed;		// Inactive symmetries popped from 'sym_queue', examined after the active ones.
 	vec<Lit> 			implic;				// used when constructing clauses
+	vec<uint64_t>		analyze_compat;		// Compatible symmetries of the clause being learnt (see 'CompatSets').
+	std::vector<Lit>	symmetry_clause;	// ESBP handed over by cosy, reused from one injection to the next.
+	vec<uint32_t>		lit_stamp;			// 'lit_stamp[lit] == lit_stamp_time' iff 'lit' was given to the last 'stampLits()'.
+	uint32_t			lit_stamp_time;
+	vec<uint64_t>		stab_ids;			// Symmetries not yet refuted by 'addStabilizers()'.
+	vec<uint64_t>		stab_tested;		// Symmetries already counted against 'stab_cap'.
 	const static bool	debug=false; 		// if true the slow test methods are enabled
 
     // Static helpers:
@@ -376,6 +408,7 @@ protected:
         return (int)(drand(seed) * size); }
 
 	friend class Symmetry;
+	friend class Snapshot;
 
 };
 
@@ -424,7 +457,18 @@ inline bool     Solver::addClause       (Lit p, Lit q)          { add_tmp.clear(
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
 inline bool     Solver::isRemoved       (CRef cr)         const { return ca[cr].mark() == 1; }
 inline bool     Solver::locked          (const Clause& c) const { return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c; }
-inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
+template<class Lits>
+inline void     Solver::stampLits(const Lits& lits)
+{
+    if (++lit_stamp_time == 0){
+        for (int i = 0; i < lit_stamp.size(); i++)
+            lit_stamp[i] = 0;
+        lit_stamp_time = 1; }
+    for (int i = 0; i < (int)lits.size(); i++)
+        lit_stamp[toInt(lits[i])] = lit_stamp_time;
+}
+
+inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); if (symmetry != nullptr) symmetry->newDecisionLevel(); }
 
 inline int      Solver::decisionLevel ()      const   { return trail_lim.size(); }
 inline uint32_t Solver::abstractLevel (Var x) const   { return 1 << (level(x) & 31); }
@@ -486,10 +530,14 @@ inline void     Solver::toDimacs     (const char* file, Lit p, Lit q, Lit r){ ve
 //=================================================================================================
 // Symmetry -- a class to represent a symmetry:
 
+// A 'Lit' and a 'cosy::Literal' have the same index (2 * var + sign), so the symmetries read the
+// lookup tables of the cosy permutations directly.
+static inline cosy::Literal toCosy  (Lit l)           { return cosy::Literal(cosy::LiteralIndex(toInt(l))); }
+static inline Lit           fromCosy(cosy::Literal l) { return toLit(l.index().value()); }
+
 class Symmetry{
 private:
-	vec<Lit> sym;
-	vec<Lit> inv;
+	std::shared_ptr<const cosy::PermutationTable<cosy::Literal>> perm;	// images and inverses, sized to the support
 	Solver* s;
 	int id;
 	vec<Lit> notifiedLits;
@@ -503,30 +551,9 @@ private:
 public:
 
 
-	Symmetry(Solver* solver, vec<Lit>& from, vec<Lit>& to, int id):
-		s(solver),id(id){
-		assert(from.size()==to.size());
-		int maxIndex = 0;
-		for(int i=0; i<from.size(); ++i){
-			if(from[i]!=to[i]){
-				if(toInt(from[i])>maxIndex){
-					maxIndex=toInt(from[i]);
-				}
-				if(toInt(to[i])>maxIndex){
-					maxIndex=toInt(from[i]);
-				}
-			}
-		}
-		sym.growTo(maxIndex+1);
-		inv.growTo(maxIndex+1);
-		for(int i=0; i<sym.size(); ++i){
-			sym[i]=toLit(i);
-			inv[i]=toLit(i);
-		}
-		for(int i=0; i<from.size(); ++i){
-			sym[toInt(from[i])]=to[i];
-			inv[toInt(to[i])]=from[i];
-		}
+	Symmetry(Solver* solver, std::shared_ptr<const cosy::PermutationTable<cosy::Literal>> table, int id):
+		perm(table),s(solver),id(id){
+		assert(perm->isBuilt());
 		amountNeededForActive=0;
 		reasonOfPermInactive=lit_Undef;
 		nextToPropagate=0;
@@ -537,11 +564,9 @@ public:
 
 	void print(){
 		printf("Symmetry: %i - neededForActive: %i\n",getId(),amountNeededForActive);
-		for(int i=0; i<sym.size(); ++i){
-			if(sym[i]!=toLit(i)){
-				printf("%i->%i | ",s->toDimacs(toLit(i)),s->toDimacs(sym[i]));
-			}
-		}printf("\n notifiedLits: ");
+		perm->forEachMoved([this](cosy::Literal l, cosy::Literal image){
+			printf("%i->%i | ",s->toDimacs(fromCosy(l)),s->toDimacs(fromCosy(image)));
+		});printf("\n notifiedLits: ");
 		for(int i=0; i<notifiedLits.size(); ++i){
 			printf("%i:",toInt(notifiedLits[i]));
 			s->testPrintValue(notifiedLits[i]);
@@ -575,49 +600,26 @@ public:
 		}
 	}
 
-        bool stabilize(const vec<Lit>& clause){
-            int i;
-            for (int j=0; j<clause.size(); j++) {
-                Lit p = clause[j];
+        // Linear in the clause size: its literals are stamped in the solver, so each image is
+        // found in constant time. To test all the symmetries, see 'Solver::addStabilizers()'.
+        template<class Lits>
+        bool stabilize(const Lits& clause){
+            s->stampLits(clause);
+            return stabilizeStamped(clause);
+        }
 
+        // Same, with 'clause' already given to 'Solver::stampLits()'.
+        template<class Lits>
+        bool stabilizeStamped(const Lits& clause){
+            for (int j=0; j<(int)clause.size(); j++) {
+                Lit p = clause[j];
                 Lit symmetrical = getSymmetrical(p);
 
-                if (p == symmetrical)
-                    continue;
-
-                for (i = 0; i<clause.size(); i++) {
-                    if (clause[i] == symmetrical)
-                        break;
-                }
-
-                if (i == clause.size()) {
+                if (p != symmetrical && !s->isStamped(symmetrical))
                     return false;
-                }
-	  }
+            }
             return true;
-	}
-
-	 bool stabilize(const Clause& clause){
-             int i;
-             for (int j=0; j<clause.size(); j++) {
-                 Lit p = clause[j];
-
-                 Lit symmetrical = getSymmetrical(p);
-
-                 if (p == symmetrical)
-                     continue;
-
-                 for (i = 0; i<clause.size(); i++) {
-                     if (clause[i] == symmetrical)
-                         break;
-                 }
-
-                 if (i == clause.size()) {
-                     return false;
-                 }
-             }
-             return true;
-         }
+        }
 
          //TODO: this method should never get called when clause isn't unit or conflict, so code could be simpler
          //	@post: 	out_clause is one of three options, depending on the number of unknown literals:
@@ -658,17 +660,11 @@ public:
 
 
 	Lit getSymmetrical(Lit l){
-		if(toInt(l)>=sym.size()){
-			return l;
-		}
-		return sym[toInt(l)];
+		return fromCosy(perm->imageOf(toCosy(l)));
 	}
 
 	Lit getInverse(Lit l){
-		if(toInt(l)>=inv.size()){
-			return l;
-		}
-		return inv[toInt(l)];
+		return fromCosy(perm->inverseOf(toCosy(l)));
 	}
 
 	Lit getNextToPropagate(){
@@ -708,7 +704,7 @@ public:
 		}
 		/*
 		if(s->level(var(l))==0){
-                    return  s->symmetry_units.find(var(l)) != s->symmetry_units.end();
+                    return  s->isSymmetryUnit(var(l));
 		    }*/
 		Clause& cl = s->ca[s->reason(var(l))];
 		bool noUndefYet = true;
@@ -736,13 +732,25 @@ public:
             breakUnits.clear();
             assert(breakUnits.size() == 0);
             breakUnitsIndex = 0;
+            markPending();
         }
 
         void cancelReasonOfBreaked(Lit p) {
-            if (reasonOfBreaked != lit_Undef && reasonOfBreaked == p)
+            if (reasonOfBreaked != lit_Undef && reasonOfBreaked == p){
                 reasonOfBreaked = lit_Undef;
+                markPending();
+            }
         }
 
+	// Queue the symmetry for the next symmetry propagation round of 'Solver::propagate()'. A symmetry
+	// which is not queued has nothing to propagate: every change of 'notifiedLits' or of the activity
+	// goes through 'notifyEnqueued()', 'notifyBacktrack()', 'cancelReasonOfBreaked()' or 'resetBreakUnits()'.
+	void markPending(){
+		if(!s->sym_queue.inHeap(id)){
+			s->sym_queue.insert(id);
+		}
+	}
+
         void notifyReasonOfBreaked(Lit l) {
             if(!isStab()) return;
             reasonOfBreaked = l;
@@ -752,6 +760,9 @@ public:
 		assert(getSymmetrical(l)!=l);
 		assert(s->value(l)==l_True);
 		notifiedLits.push(l);
+		if(s->inactivePropagationOptimization){
+			markPending();
+		}
 
 		if(isPermanentlyInactive() ) {
                     return;
@@ -761,7 +772,7 @@ public:
 		Lit symmetrical = getSymmetrical(l);
 
                 if (s->level(var(l)) == 0 &&
-		    s->symmetry_units.find(var(l)) != s->symmetry_units.end()) { // COSY UNIT BREAK
+		    s->isSymmetryUnit(var(l))) { // COSY UNIT BREAK
                     breakUnits.push(l);
 
 		    for (;breakUnitsIndex < breakUnits.size(); breakUnitsIndex++) {
@@ -792,6 +803,10 @@ public:
 			}
 			// else s->value(symmetrical)==l_True
 		}
+
+		if(isActive()){
+			markPending();
+		}
 	}
 
 	void notifyBacktrack(Lit l){
@@ -800,6 +815,9 @@ public:
 		assert(notifiedLits.size()>0 && notifiedLits.last()==l);
 		notifiedLits.pop();
 		nextToPropagate=0;
+		if(s->inactivePropagationOptimization){
+			markPending();
+		}
 
 		if(isPermanentlyInactive()){
 			if(reasonOfPermInactive==l){
@@ -815,6 +833,10 @@ public:
 		if( s->isDecision(getInverse(l)) && s->value(getInverse(l))==l_True){
 			++amountNeededForActive;
 		}
+
+		if(isActive()){
+			markPending();
+		}
 	}
 
 	bool isActive(){
@@ -24,8 +24,6 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include <assert.h>
 #include <iostream>
-#include <memory>
-#include <set>
 
 #include "minisat/mtl/IntTypes.h"
 #include "minisat/mtl/Alg.h"
@@ -140,33 +138,40 @@ class Clause;
 class Symmetry;
 
 typedef RegionAllocator<uint32_t>::Ref CRef;
+typedef uint32_t CompatRef;
 
+const CompatRef CompatRef_Empty = 0;
+const CompatRef CompatRef_Undef = UINT32_MAX;
+
+// A symmetry clause with a non-empty set of compatible symmetries stores its handle in a word
+// after the literals and the extra field. Other clauses do not have this word.
 class Clause {
-    std::unique_ptr< std::set<Symmetry*> > perms;
     struct {
-        unsigned mark      : 2;
-        unsigned learnt    : 1;
-        unsigned symmetry  : 1;
-        unsigned fsymmetry : 1;
-        unsigned has_extra : 1;
-        unsigned reloced   : 1;
-        unsigned size      : 24; }                        header;
-    union { Lit lit; float act; uint32_t abs; CRef rel; } data[0];
+        unsigned mark       : 2;
+        unsigned learnt     : 1;
+        unsigned symmetry   : 1;
+        unsigned fsymmetry  : 1;
+        unsigned has_extra  : 1;
+        unsigned has_compat : 1;
+        unsigned reloced    : 1;
+        unsigned size       : 23; }                                         header;
+    union { Lit lit; float act; uint32_t abs; CRef rel; CompatRef compat; } data[0];
 
     friend class ClauseAllocator;
 
     // NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
-    Clause(const vec<Lit>& ps, bool use_extra, bool learnt, bool fsymmetry, bool symmetry,
-           std::unique_ptr<std::set<Symmetry*>>& p) : perms(std::move(p)) {
-        header.mark      = 0;
-        header.learnt    = learnt;
-        header.fsymmetry = fsymmetry;
-        header.symmetry  = symmetry;
-        header.has_extra = use_extra;
-        header.reloced   = 0;
-        header.size      = ps.size();
-
-        for (int i = 0; i < ps.size(); i++)
+    template<class V>
+    Clause(const V& ps, bool use_extra, bool learnt, bool fsymmetry, bool symmetry, CompatRef compat) {
+        header.mark       = 0;
+        header.learnt     = learnt;
+        header.fsymmetry  = fsymmetry;
+        header.symmetry   = symmetry;
+        header.has_extra  = use_extra;
+        header.has_compat = compat != CompatRef_Empty;
+        header.reloced    = 0;
+        header.size       = ps.size();
+
+        for (int i = 0; i < (int)ps.size(); i++)
             data[i].lit = ps[i];
 
         if (header.has_extra){
@@ -175,11 +180,12 @@ class Clause {
             else
                 calcAbstraction();
         }
+        if (header.has_compat)
+            data[header.size + header.has_extra].compat = compat;
     }
 
     // NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
     Clause(Clause& from, bool use_extra){
-        perms            = std::move(from.perms);
         header           = from.header;
         header.has_extra = use_extra;   // NOTE: the copied clause may lose the extra field.
 
@@ -192,6 +198,8 @@ class Clause {
             else
                 data[header.size].abs = from.data[header.size].abs;
         }
+        if (header.has_compat)
+            data[header.size + header.has_extra].compat = from.compat();
     }
 
 public:
@@ -204,7 +212,10 @@ public:
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    void         shrink      (int i)         { assert(i <= size());
+                                               for (int k = 0; k < (int)header.has_extra + (int)header.has_compat; k++)
+                                                   data[header.size-i+k] = data[header.size+k];
+                                               header.size -= i; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     bool         symmetry    ()      const   { return header.symmetry; }
@@ -212,9 +223,11 @@ public:
     bool         fsymmetry   ()      const   { return header.fsymmetry; }
     void         fsymmetry   (uint32_t s)    { header.fsymmetry = s; }
 
-    std::set<Symmetry*>*  scompat()          { return perms.get(); }
 
     bool         has_extra   ()      const   { return header.has_extra; }
+    bool         has_compat  ()      const   { return header.has_compat; }
+    CompatRef    compat      ()      const   { return header.has_compat ? data[header.size + header.has_extra].compat : CompatRef_Empty; }
+    void         compat      (CompatRef r)   { assert(header.has_compat); data[header.size + header.has_extra].compat = r; }
     uint32_t     mark        ()      const   { return header.mark; }
     void         mark        (uint32_t m)    { header.mark = m; }
     const Lit&   last        ()      const   { return data[header.size-1].lit; }
@@ -237,6 +250,95 @@ public:
 };
 
 
+//=================================================================================================
+// CompatSets -- interned sets of symmetry ids, referenced by 32-bit handles:
+//
+// A symmetry clause records the symmetries it is compatible with (those stabilizing it, or those
+// of the clauses it was derived from). A set is a bitset over the symmetry ids and each distinct
+// set is stored once, so that derived clauses share the handle of their antecedent. Set 0 is the
+// empty set. Sets are never freed: the pool is compacted with the clauses on garbage collection.
+
+class CompatSets
+{
+    struct SetHash  { const CompatSets* cs; uint32_t operator()(CompatRef r) const { return cs->hashOf(r); } };
+    struct SetEqual { const CompatSets* cs; bool     operator()(CompatRef r, CompatRef s) const { return cs->equal(r, s); } };
+
+    int                                      n_words;   // Number of 64-bit words of a set.
+    vec<uint64_t>                            words;     // Set 'r' is 'words[r*n_words .. (r+1)*n_words-1]'.
+    Map<CompatRef, CompatRef, SetHash, SetEqual> index;  // Maps every set to itself, to find equal sets.
+    vec<CompatRef>                           reloced;   // Handle of each set in the pool of the last 'reloc()'.
+
+    uint32_t hashOf(CompatRef r) const {
+        const uint64_t* set = &words[r * n_words];
+        uint64_t h = 0;
+        for (int i = 0; i < n_words; i++)
+            h = (h ^ set[i]) * 0x100000001b3ULL;
+        return (uint32_t)(h ^ (h >> 32)); }
+
+    bool equal(CompatRef r, CompatRef s) const {
+        for (int i = 0; i < n_words; i++)
+            if (words[r * n_words + i] != words[s * n_words + i]) return false;
+        return true; }
+
+    // Don't allow copying (the hash and equality objects point to this pool):
+    CompatSets& operator=(const CompatSets& other);
+    CompatSets           (const CompatSets& other);
+
+ public:
+    CompatSets() : n_words(0), index(SetHash{this}, SetEqual{this}) {}
+
+    int        nWords    ()      const { return n_words; }
+    int        size      ()      const { return n_words == 0 ? 1 : words.size() / n_words; }
+
+    // Set the number of symmetry ids. Only the empty set may be interned yet.
+    void growTo(int n_ids) {
+        assert(size() == 1);
+        n_words = (n_ids + 63) / 64;
+        words.clear();
+        words.growTo(n_words, 0);
+        index.clear();
+        index.insert(CompatRef_Empty, CompatRef_Empty); }
+
+    bool            has       (CompatRef r, int id) const { return n_words > 0 && (words[r * n_words + (id >> 6)] >> (id & 63)) & 1; }
+    const uint64_t* operator[](CompatRef r)         const { return &words[r * n_words]; }
+
+    // Handle of the set of 'nWords()' words 'set', which is interned if new.
+    CompatRef intern(const uint64_t* set) {
+        if (n_words == 0) return CompatRef_Empty;
+        CompatRef r = words.size() / n_words;
+        for (int i = 0; i < n_words; i++)
+            words.push(set[i]);
+        CompatRef found;
+        if (index.peek(r, found)){
+            words.shrink(n_words);
+            return found; }
+        index.insert(r, r);
+        return r; }
+
+    // Helpers to build a set before interning it:
+    void        clearSet(vec<uint64_t>& set)      const { set.clear(); set.growTo(n_words, 0); }
+    static void addId   (vec<uint64_t>& set, int id)    { set[id >> 6] |= (uint64_t)1 << (id & 63); }
+    static bool hasId   (const vec<uint64_t>& set, int id){ return (set[id >> 6] >> (id & 63)) & 1; }
+
+    // Handle in 'to' of the set 'r' of this pool.
+    CompatRef reloc(CompatRef r, CompatSets& to) {
+        if (to.n_words != n_words) to.growTo(n_words * 64);
+        if (reloced.size() < size()) reloced.growTo(size(), CompatRef_Undef);
+        if (reloced[r] == CompatRef_Undef)
+            reloced[r] = to.intern(&words[r * n_words]);
+        return reloced[r]; }
+
+    // NOTE: the hash and equality objects are not moved, they refer to 'to' already. A pool no set
+    // was reloced to keeps the width of 'to'.
+    void moveTo(CompatSets& to) {
+        if (n_words != to.n_words) growTo(to.n_words * 64);
+        to.n_words = n_words;
+        words.moveTo(to.words);
+        index.moveTo(to.index);
+        to.reloced.clear();
+        reloced.clear(); }
+};
+
 //=================================================================================================
 // ClauseAllocator -- a simple class for allocating memory for clauses:
 
@@ -244,9 +346,10 @@ const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
 class ClauseAllocator
 {
     RegionAllocator<uint32_t> ra;
+    CompatSets                compat_sets;
 
-    static uint32_t clauseWord32Size(int size, bool has_extra){
-        return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra))) / sizeof(uint32_t); }
+    static uint32_t clauseWord32Size(int size, bool has_extra, bool has_compat){
+        return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra + (int)has_compat))) / sizeof(uint32_t); }
 
  public:
     enum { Unit_Size = RegionAllocator<uint32_t>::Unit_Size };
@@ -258,16 +361,19 @@ class ClauseAllocator
 
     void moveTo(ClauseAllocator& to){
         to.extra_clause_field = extra_clause_field;
-        ra.moveTo(to.ra); }
+        ra.moveTo(to.ra);
+        compat_sets.moveTo(to.compat_sets); }
 
-    CRef alloc(const vec<Lit>& ps, bool learnt = false, bool fsymmetry = false, bool symmetry = false,
-               std::unique_ptr<std::set<Symmetry*>>&& perms = nullptr)
+    template<class Lits>
+    CRef alloc(const Lits& ps, bool learnt = false, bool fsymmetry = false, bool symmetry = false,
+               CompatRef compat = CompatRef_Empty)
     {
         assert(sizeof(Lit)      == sizeof(uint32_t));
         assert(sizeof(float)    == sizeof(uint32_t));
         bool use_extra = learnt | extra_clause_field;
-        CRef cid       = ra.alloc(clauseWord32Size(ps.size(), use_extra));
-        new (lea(cid)) Clause(ps, use_extra, learnt, fsymmetry, symmetry, perms);
+        if (!symmetry) compat = CompatRef_Empty;
+        CRef cid       = ra.alloc(clauseWord32Size(ps.size(), use_extra, compat != CompatRef_Empty));
+        new (lea(cid)) Clause(ps, use_extra, learnt, fsymmetry, symmetry, compat);
 
         return cid;
     }
@@ -275,13 +381,16 @@ class ClauseAllocator
     CRef alloc(Clause& from)
     {
         bool use_extra = from.learnt() | extra_clause_field;
-        CRef cid       = ra.alloc(clauseWord32Size(from.size(), use_extra));
+        CRef cid       = ra.alloc(clauseWord32Size(from.size(), use_extra, from.has_compat()));
         new (lea(cid)) Clause(from, use_extra);
         return cid; }
 
     uint32_t size      () const      { return ra.size(); }
     uint32_t wasted    () const      { return ra.wasted(); }
 
+    CompatSets&       compatSets()       { return compat_sets; }
+    const CompatSets& compatSets() const { return compat_sets; }
+
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
     Clause&       operator[](CRef r)         { return (Clause&)ra[r]; }
     const Clause& operator[](CRef r) const   { return (Clause&)ra[r]; }
@@ -292,8 +401,7 @@ class ClauseAllocator
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        delete c.scompat();
-        ra.free(clauseWord32Size(c.size(), c.has_extra()));
+        ra.free(clauseWord32Size(c.size(), c.has_extra(), c.has_compat()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
@@ -305,6 +413,8 @@ class ClauseAllocator
         c.relocate(cr);
         to[cr].fsymmetry(c.fsymmetry());
         to[cr].symmetry(c.symmetry());
+        if (c.has_compat())
+            to[cr].compat(compat_sets.reloc(c.compat(), to.compat_sets));
     }
 };
 
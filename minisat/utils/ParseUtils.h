@@ -23,37 +23,42 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <zlib.h>
 
-#include "minisat/mtl/XAlloc.h"
+#include "minisat/mtl/IntTypes.h"
+#include "cosy/GzipReader.h"
 
 namespace Minisat {
 
 //-------------------------------------------------------------------------------------------------
-// A simple buffered character stream class:
+// A buffered character stream class over a gzip stream:
 
 
 
 class StreamBuffer {
-    gzFile         in;
-    unsigned char* buf;
-    int            pos;
-    int            size;
-
-    enum { buffer_size = 64*1024 };
+    cosy::GzipReader     reader;   // Decompresses ahead in a background thread, on multicore machines.
+    const unsigned char* buf;
+    int                  pos;
+    int                  size;
 
     void assureLookahead() {
         if (pos >= size) {
+            unsigned int n;
             pos  = 0;
-            size = gzread(in, buf, buffer_size); } }
+            buf  = reader.next(&n);
+            size = n; } }
 
 public:
-    explicit StreamBuffer(gzFile i) : in(i), pos(0), size(0){
-        buf = (unsigned char*)xrealloc(NULL, buffer_size);
+    explicit StreamBuffer(gzFile i) : reader(i), buf(NULL), pos(0), size(0){
         assureLookahead();
     }
-    ~StreamBuffer() { free(buf); }
 
     int  operator *  () const { return (pos >= size) ? EOF : buf[pos]; }
     void operator ++ ()       { pos++; assureLookahead(); }
@@ -61,11 +66,54 @@ public:
 };
 
 
+//-------------------------------------------------------------------------------------------------
+// A character stream over a memory mapped file, read in place. Only uncompressed regular files
+// are mapped: 'mapped()' is false for the others (gzip, pipes, ...), which are left to
+// StreamBuffer.
+
+
+class MappedBuffer {
+    const char* data;
+    const char* pos;
+    const char* end;
+    size_t      size;
+
+public:
+    explicit MappedBuffer(const char* filename) : data(NULL), pos(NULL), end(NULL), size(0) {
+        int         fd = open(filename, O_RDONLY);
+        struct stat st;
+        if (fd < 0) return;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0){
+            void* addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED){
+                const unsigned char* head = (const unsigned char*)addr;
+                if (st.st_size >= 2 && head[0] == 0x1f && head[1] == 0x8b)
+                    munmap(addr, st.st_size);
+                else{
+                    madvise(addr, st.st_size, MADV_SEQUENTIAL);
+                    data = pos = (const char*)addr;
+                    size = st.st_size;
+                    end  = data + size; } } }
+        close(fd); }
+    ~MappedBuffer() { if (data != NULL) munmap((void*)data, size); }
+
+    bool mapped      () const { return data != NULL; }
+    int  operator *  () const { return (pos >= end) ? EOF : (unsigned char)*pos; }
+    void operator ++ ()       { pos++; }
+    int64_t position () const { return pos - data; }  // Files can be larger than 2 GB.
+
+    // Direct access to the remaining characters, for the parse functions below.
+    const char*& cursor()     { return pos; }
+    const char*  limit () const { return end; }
+};
+
+
 //-------------------------------------------------------------------------------------------------
 // End-of-file detection functions for StreamBuffer and char*:
 
 
 static inline bool isEof(StreamBuffer& in) { return *in == EOF;  }
+static inline bool isEof(MappedBuffer& in) { return *in == EOF;  }
 static inline bool isEof(const char*   in) { return *in == '\0'; }
 
 //-------------------------------------------------------------------------------------------------
@@ -100,6 +148,63 @@ static int parseInt(B& in) {
     return neg ? -val : val; }
 
 
+//-------------------------------------------------------------------------------------------------
+// Parse functions specialized for MappedBuffer, which scan the mapped characters directly.
+
+
+static inline void skipWhitespace(MappedBuffer& in) {
+    const char*& p   = in.cursor();
+    const char*  end = in.limit();
+    while (p < end && ((*p >= 9 && *p <= 13) || *p == 32))
+        p++; }
+
+
+static inline void skipLine(MappedBuffer& in) {
+    const char*& p  = in.cursor();
+    const char*  nl = (const char*)memchr(p, '\n', in.limit() - p);
+    p = (nl == NULL) ? in.limit() : nl + 1; }
+
+
+// Reads a run of decimal digits eight characters at a time: the characters are loaded in one
+// word, the digit count is the position of the first non-digit byte and the digits are combined
+// pairwise in three multiplications. The tail of the file is read one character at a time.
+static inline int parseDigits(const char*& p, const char* end) {
+    static const int pow10[9] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+    int val = 0;
+    while (end - p >= 8){
+        uint64_t w;
+        memcpy(&w, p, 8);
+        w -= UINT64_C(0x3030303030303030);
+        uint64_t non_digit = (w | (w + UINT64_C(0x7676767676767676))) & UINT64_C(0x8080808080808080);
+        int      n         = (non_digit == 0) ? 8 : __builtin_ctzll(non_digit) >> 3;
+        if (n < 4){
+            // Short numbers, the most frequent, are cheaper to combine one digit at a time:
+            for (int k = 0; k < n; k++)
+                val = val*10 + (p[k] - '0');
+            p += n;
+            return val; }
+        w <<= 8 * (8 - n);
+        w = ((w & UINT64_C(0x0F0F0F0F0F0F0F0F)) * 2561) >> 8;
+        w = ((w & UINT64_C(0x00FF00FF00FF00FF)) * 6553601) >> 16;
+        w = ((w & UINT64_C(0x0000FFFF0000FFFF)) * UINT64_C(42949672960001)) >> 32;
+        val = val * pow10[n] + (int)w;
+        p  += n;
+        if (n < 8) return val; }
+    while (p < end && *p >= '0' && *p <= '9')
+        val = val*10 + (*p++ - '0');
+    return val; }
+
+
+static inline int parseInt(MappedBuffer& in) {
+    bool neg = false;
+    skipWhitespace(in);
+    if      (*in == '-') neg = true, ++in;
+    else if (*in == '+') ++in;
+    if (*in < '0' || *in > '9') fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", *in), exit(3);
+    int val = parseDigits(in.cursor(), in.limit());
+    return neg ? -val : val; }
+
+
 // String matching: in case of a match the input iterator will be advanced the corresponding
 // number of characters.
 template<class B>
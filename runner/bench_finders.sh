@@ -0,0 +1,45 @@
+#!/bin/bash
+#
+# Runs the in-process symmetry finders on a corpus of CNF files and prints,
+# for each instance and finder, the detection time, the number of generators
+# and the order of the group they generate, as used by cosy and the static
+# breaking, and the peak memory once the group is found. Two finders may
+# return different generators of the same group: the breaking of cosy
+# follows the generators, fewer of them break fewer symmetries.
+#
+# usage: bench_finders.sh <cnf-file-or-directory>... [-- <minisat options>]
+#
+# Environment: FINDERS (default "bliss saucy"), CPU_LIMIT in seconds for
+# each run (default 60), MINISAT (default minisat_core next to this script).
+
+MINISAT=${MINISAT:-$(dirname $0)/minisat_core}
+FINDERS=${FINDERS:-bliss saucy}
+CPU_LIMIT=${CPU_LIMIT:-60}
+
+FILES=()
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+    if [ -d "$1" ]; then
+        FILES+=($(find "$1" -name "*.cnf" -o -name "*.cnf.gz" | sort))
+    else
+        FILES+=("$1")
+    fi
+    shift
+done
+[ "$1" == "--" ] && shift
+
+field() {
+    echo "$1" | grep "$2" | head -1 | sed 's/^[^:]*: *//; s/ *|$//' | awk '{print $1}'
+}
+
+printf "%-32s %-6s %10s %10s %12s %10s\n" "instance" "finder" "time(s)" "gens" "order" "mem(MB)"
+for cnf in "${FILES[@]}"; do
+    for finder in $FINDERS; do
+        out=$($MINISAT -verb=2 -sym-finder=$finder -cpu-lim=$CPU_LIMIT "$@" "$cnf" 2>&1)
+        time=$(field "$out" "Symmetry detection:")
+        gens=$(field "$out" "Group generators:")
+        order=$(field "$out" "Group order:")
+        mem=$(field "$out" "Memory with group:")
+        printf "%-32s %-6s %10s %10s %12s %10s\n" "$(basename $cnf)" "$finder" \
+               "${time:--}" "${gens:--}" "${order:--}" "${mem:--}"
+    done
+done
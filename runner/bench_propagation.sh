@@ -0,0 +1,57 @@
+#!/bin/bash
+#
+# Measures the propagation throughput of one or more minisat_core builds:
+# for each instance and build, the number of propagations, the CPU time of
+# the best of RUNS runs and the resulting propagations per second. Several
+# builds are compared on the same instances by listing them in MINISATS.
+#
+# usage: bench_propagation.sh <cnf-file-or-directory>... [-- <minisat options>]
+#
+# Environment: MINISATS (default minisat_core next to this script), RUNS
+# per instance and build (default 3), CPU_LIMIT in seconds for each run
+# (default 60).
+
+MINISATS=${MINISATS:-$(dirname $0)/minisat_core}
+RUNS=${RUNS:-3}
+CPU_LIMIT=${CPU_LIMIT:-60}
+
+FILES=()
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+    if [ -d "$1" ]; then
+        FILES+=($(find "$1" -name "*.cnf" -o -name "*.cnf.gz" | sort))
+    else
+        FILES+=("$1")
+    fi
+    shift
+done
+[ "$1" == "--" ] && shift
+
+field() {
+    echo "$1" | grep "^$2" | head -1 | sed 's/^[^:]*: *//' | awk '{print $1}'
+}
+
+build=0
+for minisat in $MINISATS; do
+    build=$((build + 1))
+    echo "build $build: $minisat"
+done
+
+printf "%-24s %6s %12s %10s %10s\n" "instance" "build" "props" "time(s)" "Mprops/s"
+for cnf in "${FILES[@]}"; do
+    build=0
+    for minisat in $MINISATS; do
+        build=$((build + 1))
+        best=""
+        for run in $(seq $RUNS); do
+            out=$($minisat -cpu-lim=$CPU_LIMIT "$@" "$cnf" 2>&1)
+            props=$(field "$out" "propagations")
+            time=$(field "$out" "CPU time")
+            if [ -z "$best" ] || awk "BEGIN { exit !($time < $best) }"; then
+                best=$time
+            fi
+        done
+        rate=$(awk "BEGIN { if ($best > 0) printf \"%.2f\", $props / $best / 1e6 }")
+        printf "%-24s %6s %12s %10s %10s\n" "$(basename $cnf)" "$build" \
+               "${props:--}" "${best:--}" "${rate:--}"
+    done
+done
@@ -0,0 +1,47 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#ifndef INCLUDE_COSY_AUTOMORPHISMCHECKER_H_
+#define INCLUDE_COSY_AUTOMORPHISMCHECKER_H_
+
+#include <vector>
+
+#include "cosy/CNFModel.h"
+#include "cosy/IntegralTypes.h"
+#include "cosy/Literal.h"
+#include "cosy/Macros.h"
+#include "cosy/Permutation.h"
+
+namespace cosy {
+
+// Checks that permutations are automorphisms of a CNF model: the image of
+// each clause is a clause of the model. The clauses of each literal are
+// indexed once, so that a check only maps the clauses of the support.
+class AutomorphismChecker {
+ public:
+    AutomorphismChecker(const CNFModel& model, unsigned int num_vars);
+    ~AutomorphismChecker() {}
+
+    // The permutation must be built
+    bool isAutomorphism(const Permutation& permutation);
+
+ private:
+    const CNFModel& _model;
+    std::vector<int64> _occurence_starts;
+    std::vector<int64> _occurence_clauses;
+    std::vector<Literal> _mapped;
+    std::vector<int> _checked;
+    int _stamp;
+
+    DISALLOW_COPY_AND_ASSIGN(AutomorphismChecker);
+};
+
+}  // namespace cosy
+
+#endif  // INCLUDE_COSY_AUTOMORPHISMCHECKER_H_
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
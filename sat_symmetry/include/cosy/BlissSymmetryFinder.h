@@ -4,6 +4,7 @@
 #define INCLUDE_COSY_BLISSSYMMETRYFINDER_H_
 
 #include <string>
+#include <vector>
 
 #include "cosy/SymmetryFinder.h"
 #include "cosy/CNFGraph.h"
@@ -17,8 +18,15 @@ class BlissSymmetryFinder : public SymmetryFinder {
         SymmetryFinder(model) {}
     ~BlissSymmetryFinder() {}
 
+    // A graph of several connected components is searched component by
+    // component, on the threads of the budget
     void findAutomorphism(Group *group) override;
     std::string toolName() const override { return std::string("Bliss"); }
+
+ private:
+    void searchGraph(Group *group);
+    void searchComponents(Group *group,
+                          const std::vector<std::vector<unsigned int>>& cs);
 };
 
 }  // namespace cosy
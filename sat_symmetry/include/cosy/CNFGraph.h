@@ -41,6 +41,25 @@ static inline LiteralIndex node2Literal(unsigned int node, unsigned int n) {
 }
 
 
+// Neighbours of a node, a view on the adjacency of the graph
+class Neighbours {
+ public:
+    Neighbours(const unsigned int* begin, const unsigned int* end) :
+        _begin(begin),
+        _end(end) {}
+
+    const unsigned int* begin() const { return _begin; }
+    const unsigned int* end() const { return _end; }
+    unsigned int size() const { return _end - _begin; }
+
+ private:
+    const unsigned int* _begin;
+    const unsigned int* _end;
+};
+
+// The adjacency is stored in compressed rows: the neighbours of a node are
+// _targets[_offsets[node]] to _targets[_offsets[node + 1] - 1], each edge
+// being stored in both directions.
 class CNFGraph {
  public:
     CNFGraph();
@@ -52,27 +71,39 @@ class CNFGraph {
     unsigned int numberOfNodes() const { return _num_nodes; }
     unsigned int numberOfEdges() const { return _num_edges; }
 
-    const std::vector<unsigned int> neighbour(unsigned int node) const {
-        return _adjacency[node];
+    Neighbours neighbour(unsigned int node) const {
+        return Neighbours(_targets.data() + _offsets[node],
+                          _targets.data() + _offsets[node + 1]);
     }
 
     unsigned int degree(unsigned int node) const {
-        return _adjacency[node].size();
+        return _offsets[node + 1] - _offsets[node];
     }
 
+    // Compressed rows, to load the whole adjacency at once
+    const unsigned int* offsets() const { return _offsets.data(); }
+    const unsigned int* targets() const { return _targets.data(); }
+
+    int64 memoryUsage() const;
+
     unsigned int color(unsigned int node) const {
         return _colors[node];
     }
 
+    // Connected components, each as its nodes in increasing order. The
+    // components are ordered by their smallest node.
+    std::vector<std::vector<unsigned int>> components() const;
+
  private:
     int64 _num_nodes;
     int64 _num_edges;
 
-    std::vector< std::vector<unsigned int> > _adjacency;
+    std::vector<unsigned int> _offsets;
+    std::vector<unsigned int> _targets;
     std::vector<unsigned int> _colors;
 
-    void addNode(unsigned int node);
-    void addEdge(unsigned int from, unsigned int to);
+    template <typename AddEdge>
+    unsigned int forEachEdge(const CNFModel& model, AddEdge add_edge) const;
     void changeColor(unsigned int node, unsigned int color);
 
     DISALLOW_COPY_AND_ASSIGN(CNFGraph);
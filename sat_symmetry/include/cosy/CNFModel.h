@@ -5,26 +5,92 @@
 #define INCLUDE_COSY_CNFMODEL_H_
 
 #include <algorithm>
-#include <memory>
-#include <unordered_set>
+#include <string>
 #include <vector>
 
-#include "cosy/Clause.h"
 #include "cosy/Literal.h"
 #include "cosy/Logging.h"
 
 namespace cosy {
 
+// A clause of the model, a view on its literals
+class ClauseView {
+ public:
+    ClauseView(const Literal* begin, const Literal* end) :
+        _begin(begin),
+        _end(end) {}
+
+    const Literal* begin() const { return _begin; }
+    const Literal* end() const { return _end; }
+    const Literal* literals() const { return _begin; }
+    int size() const { return _end - _begin; }
+
+ private:
+    const Literal* _begin;
+    const Literal* _end;
+};
+
+// The clauses of the model, for range based iteration:
+// for (const ClauseView clause : model.clauses()) {}
+class ClauseRange {
+ public:
+    class Iterator {
+     public:
+        Iterator(const Literal* literals, const int64* start) :
+            _literals(literals),
+            _start(start) {}
+        ClauseView operator*() const {
+            return ClauseView(_literals + _start[0], _literals + _start[1]);
+        }
+        Iterator& operator++() { ++_start; return *this; }
+        bool operator!=(const Iterator& other) const {
+            return _start != other._start;
+        }
+
+     private:
+        const Literal* _literals;
+        const int64* _start;
+    };
+
+    ClauseRange(const Literal* literals, const int64* starts, int64 size) :
+        _literals(literals),
+        _starts(starts),
+        _size(size) {}
+
+    Iterator begin() const { return Iterator(_literals, _starts); }
+    Iterator end() const { return Iterator(_literals, _starts + _size); }
+    int64 size() const { return _size; }
+
+ private:
+    const Literal* _literals;
+    const int64* _starts;
+    int64 _size;
+};
+
+// The clauses are stored without duplicates, their sorted literals one after
+// the other in a single arena.
 class CNFModel {
  public:
     CNFModel();
     ~CNFModel();
 
+    // Sizes from the header of the problem, to allocate once. They are only
+    // a hint, bounded by the model.
+    void reserve(int64 num_variables, int64 num_clauses);
+
     void addClause(std::vector<Literal>* literals);
 
-    const std::vector<std::unique_ptr<Clause>>& clauses() const {
-        return _clauses;
+    ClauseRange clauses() const {
+        return ClauseRange(_literals.data(), _clause_starts.data(),
+                           _clause_starts.size() - 1);
     }
+    ClauseView clause(int64 index) const {
+        return ClauseView(_literals.data() + _clause_starts[index],
+                          _literals.data() + _clause_starts[index + 1]);
+    }
+
+    // True if the model has the clause of the sorted distinct literals
+    bool hasClause(const std::vector<Literal>& literals) const;
 
     int64 numberOfVariables()      const { return _num_variables + 1; }
     int64 numberOfClauses()        const { return _num_clauses;       }
@@ -36,6 +102,10 @@ class CNFModel {
 
     const std::vector<int64>& occurences() const { return _occurences; }
 
+    // 128-bit hash of the set of clauses, as 32 hexadecimal digits. It does
+    // not depend on the order of the clauses nor of their literals.
+    std::string fingerprint() const;
+
     void summarize() const;
 
  private:
@@ -47,14 +117,25 @@ class CNFModel {
     int64 _num_ternary_clauses;
     int64 _num_large_clauses;
 
-    std::vector<std::unique_ptr<Clause>> _clauses;
-    std::unordered_set<size_t> _clauses_tag;
+    std::vector<Literal> _literals;
+    std::vector<int64> _clause_starts;
+    uint64 _fingerprint[2];
+
+    // Open addressing table of the clause indices, by clause hash, to find
+    // the duplicates. The hash of each clause is kept to grow the table.
+    std::vector<int64> _clause_table;
+    std::vector<uint64> _clause_hashes;
 
     std::vector<int64> _positive_occurences;
     std::vector<int64> _negative_occurences;
     std::vector<int64> _occurences;
 
-    size_t compute_tag(const std::vector<Literal>& literals);
+    uint64 compute_hash(const std::vector<Literal>& literals) const;
+    bool insert_clause(const std::vector<Literal>& literals);
+    int64 find_clause(const std::vector<Literal>& literals, uint64 hash,
+                      uint64* slot) const;
+    void resize_table(int64 size);
+    void compute_fingerprint(const std::vector<Literal>& literals);
     void compute_occurences(const std::vector<Literal>& literals);
     void compute_sizes(const std::vector<Literal>& literals);
 
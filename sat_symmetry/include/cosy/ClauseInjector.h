@@ -3,13 +3,14 @@
 #ifndef INCLUDE_COSY_CLAUSEINJECTOR_H_
 #define INCLUDE_COSY_CLAUSEINJECTOR_H_
 
-#include <deque>
-#include <unordered_set>
+#include <algorithm>
+#include <cstdint>
 #include <vector>
-#include <unordered_map>
 #include <utility>
 
+#include "cosy/Bitset.h"
 #include "cosy/Clause.h"
+#include "cosy/CNFModel.h"
 #include "cosy/Macros.h"
 #include "cosy/Literal.h"
 #include "cosy/Logging.h"
@@ -18,41 +19,127 @@
 namespace cosy {
 
 
+// Pending clauses of one type. A clause with a cause occupies the slot of
+// its cause variable until it is consumed, and a variable holds at most one
+// clause. Clauses without cause are stacked. The literals of all pending
+// clauses are bumped in one arena, which is compacted once it is mostly
+// made of consumed clauses.
 class Injector {
  public:
-    Injector() {}
+    Injector() : _num_live_literals(0) {}
     ~Injector() {}
 
-    void addClause(BooleanVariable cause, std::vector<Literal>&& literals) {
-        if (cause == kNoBooleanVariable || _clauses[cause].empty())
-            _clauses[cause].push_back(std::move(literals));
+    void resize(unsigned int num_vars) {
+        _pending.resize(num_vars, 0);
+        _slots.resize(num_vars);
     }
 
-    void removeClause(BooleanVariable cause) {
-        _clauses[cause].clear();
-    }
+    template<class Literals>
+    void addClause(BooleanVariable cause, const Literals& literals);
+    void removeClause(BooleanVariable cause);
+    bool hasClause(BooleanVariable cause) const;
+    // Consumes the clause; its literals stay in the arena until the next
+    // clause is added
+    ClauseView takeClause(BooleanVariable cause);
 
-    bool hasClause(BooleanVariable cause) const {
-        if (_clauses.find(cause) == _clauses.end())
-            return false;
+ private:
+    struct Slot {
+        unsigned int offset;
+        unsigned int size;
+    };
 
-        return _clauses.at(cause).size() > 0;
-    }
-    std::vector<Literal> getClause(BooleanVariable cause) {
-        std::vector<Literal> literals;
+    std::vector<uint8_t> _pending;
+    std::vector<Slot> _slots;
+    std::vector<Slot> _unbound;
+    std::vector<Literal> _arena;
+    unsigned int _num_live_literals;
 
-        CHECK_EQ(hasClause(cause), true);
+    template<class Literals> Slot store(const Literals& literals);
+    void release(const Slot& slot);
+    void compact();
+};
 
-        literals = std::move(_clauses[cause].back());
-        _clauses[cause].pop_back();
+template<class Literals>
+inline void Injector::addClause(BooleanVariable cause,
+                                const Literals& literals) {
+    if (cause == kNoBooleanVariable) {
+        _unbound.push_back(store(literals));
+        return;
+    }
 
-        return literals;
+    const unsigned int var = cause.value();
+    if (var >= _pending.size())
+        resize(var + 1);
+    if (_pending[var])
+        return;
+
+    _slots[var] = store(literals);
+    _pending[var] = 1;
+}
+
+inline void Injector::removeClause(BooleanVariable cause) {
+    if (cause == kNoBooleanVariable) {
+        for (const Slot& slot : _unbound)
+            release(slot);
+        _unbound.clear();
+        return;
     }
 
- private:
-    std::unordered_map<BooleanVariable,
-                       std::vector<std::vector<Literal>>> _clauses;
-};
+    const unsigned int var = cause.value();
+    if (var < _pending.size() && _pending[var]) {
+        release(_slots[var]);
+        _pending[var] = 0;
+    }
+}
+
+inline bool Injector::hasClause(BooleanVariable cause) const {
+    // The cast sends kNoBooleanVariable out of range as well
+    const unsigned int var = cause.value();
+    if (var < _pending.size())
+        return _pending[var];
+    return cause == kNoBooleanVariable && !_unbound.empty();
+}
+
+inline ClauseView Injector::takeClause(BooleanVariable cause) {
+    Slot slot;
+
+    CHECK_EQ(hasClause(cause), true);
+
+    if (cause == kNoBooleanVariable) {
+        slot = _unbound.back();
+        _unbound.pop_back();
+    } else {
+        slot = _slots[cause.value()];
+        _pending[cause.value()] = 0;
+    }
+
+    const ClauseView clause(_arena.data() + slot.offset,
+                            _arena.data() + slot.offset + slot.size);
+    release(slot);
+    return clause;
+}
+
+template<class Literals>
+inline Injector::Slot Injector::store(const Literals& literals) {
+    // The arena is only emptied or compacted here, never by release: the
+    // view of the last clause taken stays valid until then
+    const unsigned int num_dead = _arena.size() - _num_live_literals;
+    if (_num_live_literals == 0)
+        _arena.clear();
+    else if (num_dead > std::max<size_t>(_num_live_literals, _pending.size()))
+        compact();
+
+    Slot slot;
+    slot.offset = _arena.size();
+    slot.size = literals.size();
+    _arena.insert(_arena.end(), literals.begin(), literals.end());
+    _num_live_literals += slot.size;
+    return slot;
+}
+
+inline void Injector::release(const Slot& slot) {
+    _num_live_literals -= slot.size;
+}
 
 
 class ClauseInjector {
@@ -67,12 +154,23 @@ class ClauseInjector {
     ClauseInjector();
     ~ClauseInjector();
 
+    void resize(unsigned int num_vars);
 
     void addClause(Type type, BooleanVariable cause,
-                   std::vector<Literal>&& literals);
+                   const std::vector<Literal>& literals);
     void removeClause(Type type, BooleanVariable cause);
     bool hasClause(Type type, BooleanVariable cause) const;
     std::vector<Literal> getClause(Type type, BooleanVariable cause);
+    ClauseView takeClause(Type type, BooleanVariable cause);
+
+    // Clause construction in a buffer reused from one clause to the next:
+    // a literal added twice between beginClause() and endClause() is kept
+    // once, which is checked in a bitset cleared by endClause().
+    void beginClause() { DCHECK(_clause.empty()); }
+    void addLiteral(Literal literal);
+    void swapLiterals(int i, int j) { std::swap(_clause[i], _clause[j]); }
+    int clauseSize() const { return _clause.size(); }
+    void endClause(Type type, BooleanVariable cause);
 
     void removeClause(BooleanVariable cause);
 
@@ -80,6 +178,8 @@ class ClauseInjector {
 
  private:
     std::vector<Injector> _injectors;
+    std::vector<Literal> _clause;
+    Bitset64<LiteralIndex> _in_clause;
 
     struct Stats : StatsGroup {
         Stats() : StatsGroup("Clause Injector"),
@@ -96,6 +196,17 @@ class ClauseInjector {
     DISALLOW_COPY_AND_ASSIGN(ClauseInjector);
 };
 
+inline bool ClauseInjector::hasClause(Type type, BooleanVariable cause) const {
+    return _injectors[type].hasClause(cause);
+}
+
+inline void ClauseInjector::addLiteral(Literal literal) {
+    if (_in_clause.IsSet(literal.index()))
+        return;
+    _in_clause.Set(literal.index());
+    _clause.push_back(literal);
+}
+
 }  // namespace cosy
 
 #endif  // INCLUDE_COSY_CLAUSEINJECTOR_H_
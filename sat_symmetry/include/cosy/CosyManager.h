@@ -23,7 +23,12 @@ class CosyManager {
 
     void generateUnits(ClauseInjector *injector);
     void updateNotify(const Literal& literal, ClauseInjector *injector);
-    void updateCancel(const Literal& literal);
+
+    // The lookup indexes are checkpointed per decision level: cancelling
+    // levels restores each status moved in them once, whatever the number
+    // of literals unassigned. cancelUntil(-1) also restores level 0.
+    void newDecisionLevel() { _level++; }
+    void cancelUntil(int level);
 
     void summarize() const;
     void printStats() const { _stats.print(); }
@@ -35,6 +40,9 @@ class CosyManager {
 
     std::vector< std::unique_ptr<CosyStatus> > _statuses;
 
+    int _level;
+    std::vector<unsigned int> _moved;  // Statuses to backtrack, by level
+
     struct Stats : public StatsGroup {
         Stats() : StatsGroup("Cosy Manager"),
                   total_time("Cosy total time", this),
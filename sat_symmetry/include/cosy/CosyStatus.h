@@ -3,9 +3,7 @@
 #ifndef INCLUDE_COSY_COSYSTATUS_H_
 #define INCLUDE_COSY_COSYSTATUS_H_
 
-#include <deque>
 #include <vector>
-#include <unordered_set>
 #include <string>
 
 #include "cosy/Assignment.h"
@@ -32,8 +30,12 @@ class CosyStatus {
 
     void addLookupLiteral(const Literal& literal);
 
-    void updateNotify(const Literal& literal);
-    void updateCancel(const Literal& literal);
+    // Returns true if the lookup index moves for the first time at this
+    // decision level: the index to restore is then checkpointed and the
+    // caller must call backtrack() when the level is cancelled.
+    bool updateNotify(const Literal& literal, int level);
+    void backtrack();
+    int checkpointLevel() const;
 
     CosyState state() const { return _state; }
 
@@ -52,13 +54,12 @@ class CosyStatus {
     unsigned int _lookup_index;
     std::vector<Literal> _lookup_order;
 
-    struct LookupInfo {
-        LookupInfo(BooleanVariable v, unsigned int bi) :
-            variable(v), back_index(bi) {}
-        BooleanVariable variable;
-        unsigned int back_index;
+    struct Checkpoint {
+        Checkpoint(int l, unsigned int li) : level(l), lookup_index(li) {}
+        int level;
+        unsigned int lookup_index;
     };
-    std::deque<LookupInfo> _lookup_infos;
+    std::vector<Checkpoint> _checkpoints;
     CosyState _state;
 
     bool isLookupEnd() const { return _lookup_index >= _lookup_order.size(); }
@@ -67,6 +68,17 @@ class CosyStatus {
     DISALLOW_COPY_AND_ASSIGN(CosyStatus);
 };
 
+inline void CosyStatus::backtrack() {
+    DCHECK(!_checkpoints.empty());
+    _lookup_index = _checkpoints.back().lookup_index;
+    _checkpoints.pop_back();
+}
+
+inline int CosyStatus::checkpointLevel() const {
+    DCHECK(!_checkpoints.empty());
+    return _checkpoints.back().level;
+}
+
 }  // namespace cosy
 
 #endif  // INCLUDE_COSY_COSYSTATUS_H_
@@ -18,6 +18,9 @@ class Group {
     ~Group();
 
     void addPermutation(std::unique_ptr<Permutation>&& permutation);
+    // A permutation of the group which is not one of its generators, added
+    // to break more symmetries
+    void addAugmentedPermutation(std::unique_ptr<Permutation>&& permutation);
     struct Iterator;
     Iterator watch(BooleanVariable var) const;
 
@@ -32,6 +35,10 @@ class Group {
         return _num_augmented_generators;
     }
 
+    // Decimal logarithm of the order of the group, or -1 when its
+    // stabilizer chain would take more than max_words integers
+    double log10Order(int64 max_words) const;
+
     void debugPrint() const;
     void summarize(unsigned int num_vars) const;
 
@@ -0,0 +1,75 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#ifndef INCLUDE_COSY_GZIPREADER_H_
+#define INCLUDE_COSY_GZIPREADER_H_
+
+#include <zlib.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "cosy/Macros.h"
+
+namespace cosy {
+
+// Reads a gzip stream through a ring of kNumBuffers buffers. On a machine
+// with more than one core, a compressed stream is inflated by a background
+// thread while the caller parses the buffer it holds, so that decompression
+// overlaps parsing; the thread never runs more than the ring ahead of the
+// caller. Otherwise, or when the stream is not compressed, the buffers are
+// filled by the caller, as a plain gzread loop would. The stream stays owned
+// by the caller and must be closed after the reader is destroyed: the
+// characters read ahead are lost to it.
+class GzipReader {
+ public:
+    explicit GzipReader(gzFile in);
+    // Inflates in a background thread if 'background' and the stream is
+    // compressed.
+    GzipReader(gzFile in, bool background);
+    ~GzipReader();
+
+    // Gives back the buffer returned by the previous call and returns the
+    // next one, with its size in *size. The size is 0 from the end of the
+    // stream on, or after a read error.
+    const unsigned char* next(unsigned int* size);
+
+    bool threaded() const { return _thread.joinable(); }
+
+ private:
+    static const unsigned int kNumBuffers = 4;
+    static const unsigned int kBufferSize = 1 << 17;
+
+    gzFile _in;
+    std::unique_ptr<unsigned char[]> _buffers;
+    unsigned int _sizes[kNumBuffers];
+
+    // Buffer i % kNumBuffers is filled for _released <= i < _filled. The
+    // caller holds buffer _released % kNumBuffers while _holding.
+    unsigned int _filled;
+    unsigned int _released;
+    bool _holding;
+    bool _done;
+    bool _stop;
+
+    std::mutex _mutex;
+    std::condition_variable _filled_condition;
+    std::condition_variable _released_condition;
+    std::thread _thread;
+
+    void inflate();
+
+    DISALLOW_COPY_AND_ASSIGN(GzipReader);
+};
+
+}  // namespace cosy
+
+#endif  // INCLUDE_COSY_GZIPREADER_H_
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -16,6 +16,7 @@
 #define INCLUDE_COSY_LOGGING_H_
 
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
 
 #include "cosy/IntegralTypes.h"
@@ -30,14 +31,27 @@
 #define DCHECK(cond) (assert((cond)))
 #define DCHECK_NOTNULL(cond) (assert((cond != nullptr)))
 
-#define CHECK_GE(value, cond) (assert((value) >= (cond)))
-#define CHECK_LE(value, cond) (assert((value) <= (cond)))
-#define CHECK_GT(value, cond) (assert((value) >  (cond)))
-#define CHECK_LT(value, cond) (assert((value) <  (cond)))
-#define CHECK_NE(value, cond) (assert((value) !=  (cond)))
-#define CHECK_EQ(value, cond) (assert((value) == (cond)))
-#define CHECK(cond) (assert((cond)))
-#define CHECK_NOTNULL(cond) (assert((cond != nullptr)))
+// Unlike the DCHECKs, the CHECKs are also evaluated in release builds
+#define CHECK_GE(value, cond) CHECK((value) >= (cond))
+#define CHECK_LE(value, cond) CHECK((value) <= (cond))
+#define CHECK_GT(value, cond) CHECK((value) >  (cond))
+#define CHECK_LT(value, cond) CHECK((value) <  (cond))
+#define CHECK_NE(value, cond) CHECK((value) != (cond))
+#define CHECK_EQ(value, cond) CHECK((value) == (cond))
+#define CHECK(cond) \
+    ((cond) ? static_cast<void>(0) : cosy::checkFailed(#cond, __FILE__, __LINE__))
+#define CHECK_NOTNULL(cond) CHECK((cond) != nullptr)
+
+namespace cosy {
+
+[[noreturn]] inline void checkFailed(const char* condition, const char* file,
+                                     int line) {
+    std::cerr << file << ":" << line << "] Check failed: " << condition
+              << std::endl;
+    std::abort();
+}
+
+}  // namespace cosy
 
 
 struct X {
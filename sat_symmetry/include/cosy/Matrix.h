@@ -3,22 +3,50 @@
 #ifndef INCLUDE_COSY_MATRIX_H_
 #define INCLUDE_COSY_MATRIX_H_
 
+#include <memory>
+#include <vector>
+
+#include "cosy/DisjointSets.h"
+#include "cosy/Group.h"
+#include "cosy/Literal.h"
+#include "cosy/Permutation.h"
+
 namespace cosy {
 
+// Rows of positive literals of the same length, such that swapping two rows
+// literal by literal is a symmetry of the problem: any permutation of the
+// rows is then a symmetry. Some columns can also be interchangeable, they
+// are kept in classes.
 class Matrix {
  public:
-    Matrix();
+    Matrix(const std::vector<Literal>& first,
+           const std::vector<Literal>& second);
     ~Matrix();
 
-    bool canAugmentGenerator(const std::unique_ptr<Permutation> & perm);
+    unsigned int numberOfRows() const { return _matrix.size(); }
+    unsigned int numberOfColumns() const { return _matrix[0].size(); }
+    const std::vector<Literal>& row(unsigned int i) const { return _matrix[i]; }
+
+    void addRow(const std::vector<Literal>& row);
+    void joinColumns(unsigned int a, unsigned int b);
+
+    // The swaps of consecutive rows and of consecutive interchangeable
+    // columns: their lex-leader constraints sort the rows and the columns
+    // when the variables are ordered row by row.
+    void augment(Group *group, unsigned int num_vars);
 
  private:
     std::vector< std::vector<Literal> > _matrix;
+    DisjointSets _columns;
+
+    std::unique_ptr<Permutation> swap(const std::vector<Literal>& a,
+                                      const std::vector<Literal>& b,
+                                      unsigned int num_vars) const;
 };
 
 }  // namespace cosy
 
-#endif // INCLUDE_COSY_MATRIX_H_
+#endif  // INCLUDE_COSY_MATRIX_H_
 
 /*
  * Local Variables:
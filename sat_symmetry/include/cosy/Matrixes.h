@@ -1,24 +1,68 @@
 // Copyright 2017 Hakan Metin - LIP6
 
-#ifndef INCLUDE_COSY_MATRIX_H_
-#define INCLUDE_COSY_MATRIX_H_
+#ifndef INCLUDE_COSY_MATRIXES_H_
+#define INCLUDE_COSY_MATRIXES_H_
+
+#include <memory>
+#include <vector>
+
+#include "cosy/CNFModel.h"
+#include "cosy/Group.h"
+#include "cosy/Matrix.h"
 
 namespace cosy {
 
+// The row interchangeable matrices of a problem, found from the generators
+// of its group in the style of BreakID: a generator made of swaps of
+// positive literals gives the first two rows of a matrix, then the image of
+// a row by a generator is added as a new row when swapping it with the row
+// is a symmetry of the clauses. The matrices are on disjoint variables.
 class Matrixes {
  public:
-    Matrixes();
+    explicit Matrixes(const CNFModel& model);
     ~Matrixes();
 
-    bool canAugmentGenerator(const std::unique_ptr<Permutation> & perm);
+    void detect(const Group& group);
+    // Adds to the group the swaps of consecutive rows and columns
+    void augment(Group *group);
+
+    unsigned int size() const { return _matrixes.size(); }
+    const Matrix& matrix(unsigned int i) const { return *_matrixes[i]; }
+
+    void summarize() const;
 
  private:
-    std::vector< std::vector<Literal> > _matrix;
+    const CNFModel& _model;
+    const unsigned int _num_vars;
+    std::vector< std::unique_ptr<Matrix> > _matrixes;
+
+    // Matrix and column of each variable, -1 outside of the matrices
+    std::vector<int> _matrix_of;
+    std::vector<unsigned int> _column_of;
+
+    // Clauses of each literal, in compressed rows by literal index
+    std::vector<int64> _occurence_starts;
+    std::vector<int64> _occurence_clauses;
+
+    // Scratch of isSymmetry()
+    std::vector<Literal> _image;
+    std::vector<Literal> _mapped;
+    std::vector<int> _checked;
+    int _stamp;
+
+    bool isSwap(const Permutation& permutation) const;
+    bool startMatrix(const Permutation& permutation);
+    void addRow(unsigned int m, const std::vector<Literal>& row);
+    void addRows(const Group& group, unsigned int m);
+    void addColumns(const Group& group, unsigned int m);
+    bool isSymmetry(const std::vector<Literal>& a,
+                    const std::vector<Literal>& b);
+    void buildOccurences();
 };
 
 }  // namespace cosy
 
-#endif // INCLUDE_COSY_MATRIX_H_
+#endif  // INCLUDE_COSY_MATRIXES_H_
 
 /*
  * Local Variables:
@@ -16,6 +16,7 @@
 #include "cosy/DisjointSets.h"
 #include "cosy/Group.h"
 #include "cosy/Literal.h"
+#include "cosy/Matrixes.h"
 #include "cosy/Orbits.h"
 
 namespace cosy {
@@ -194,6 +195,35 @@ class BreakIDOrder : public Order {
  private:
 };
 
+/*----------------------------------------------------------------------------*/
+// The variables of the matrices first, row by row, for the swaps of their
+// consecutive rows and columns to sort them. The other variables follow in
+// the order 'rest'.
+class MatrixOrder : public Order {
+ public:
+    explicit MatrixOrder(int64 num_vars, ValueMode mode,
+                         const Matrixes& matrixes, const Order& rest) :
+        Order(num_vars, mode),
+        _rest(rest.variableModeString()) {
+        for (unsigned int m = 0; m < matrixes.size(); ++m) {
+            const Matrix& matrix = matrixes.matrix(m);
+            for (unsigned int r = 0; r < matrix.numberOfRows(); ++r)
+                for (const Literal& literal : matrix.row(r))
+                    add(literal);
+        }
+        for (const Literal& literal : rest)
+            if (!contains(literal))
+                add(literal);
+    }
+    ~MatrixOrder() {}
+    std::string variableModeString() const {
+        return std::string("matrix, then ") + _rest;
+    }
+
+ private:
+    const std::string _rest;
+};
+
 }  // namespace cosy
 #endif  // INCLUDE_COSY_ORDER_H_
 /*
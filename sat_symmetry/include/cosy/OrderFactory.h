@@ -3,21 +3,27 @@
 #ifndef INCLUDE_COSY_ORDERFACTORY_H_
 #define INCLUDE_COSY_ORDERFACTORY_H_
 
+#include <memory>
+
 #include "cosy/Order.h"
 #include "cosy/CNFModel.h"
 #include "cosy/Group.h"
+#include "cosy/Matrixes.h"
 
 namespace cosy {
 
 class OrderFactory {
  public:
+    // The variables of the matrices, if any, come first
     static Order* create(OrderMode vars, ValueMode value,
-                         const CNFModel& cnf_model, const Group& group);
+                         const CNFModel& cnf_model, const Group& group,
+                         const Matrixes *matrixes = nullptr);
 };
 
 inline Order* OrderFactory::create(OrderMode vars, ValueMode value,
                             const CNFModel& cnf_model,
-                            const Group& group) {
+                            const Group& group,
+                            const Matrixes *matrixes) {
     const unsigned int num_vars = cnf_model.numberOfVariables();
     Order *order = nullptr;
     switch (vars) {
@@ -40,6 +46,10 @@ inline Order* OrderFactory::create(OrderMode vars, ValueMode value,
         order = nullptr;
     }
 
+    if (order != nullptr && matrixes != nullptr && matrixes->size() > 0) {
+        std::unique_ptr<Order> rest(order);
+        order = new MatrixOrder(num_vars, value, *matrixes, *rest);
+    }
     return order;
 }
 
@@ -3,6 +3,7 @@
 #ifndef INCLUDE_COSY_PERMUTATION_H_
 #define INCLUDE_COSY_PERMUTATION_H_
 
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
 #include <memory>
@@ -10,16 +11,23 @@
 
 #include "cosy/Literal.h"
 #include "cosy/Logging.h"
+#include "cosy/PermutationTable.h"
 
 namespace cosy {
 
 class Permutation {
  public:
-    explicit Permutation(unsigned int size) : _size(size) {}
+    explicit Permutation(unsigned int size) :
+        _size(size),
+        _lookup(std::make_shared<PermutationTable<Literal>>()) {}
     ~Permutation() {}
 
     void addToCurrentCycle(Literal x);
     void closeCurrentCycle();
+    // Builds the lookup of images and inverses once all the cycles are
+    // added, and CHECKs that they describe a permutation. Group does it
+    // when the permutation is added.
+    void build();
 
     unsigned int size()           const { return _size; }
     unsigned int numberOfCycles() const { return _cycles_lim.size(); }
@@ -30,12 +38,18 @@ class Permutation {
     Iterator cycle(unsigned int i) const;
     Literal lastElementInCycle(unsigned int i) const;
 
+    // The image and inverse of an element outside of the support is itself
     const Literal imageOf(const Literal& element) const;
     const Literal inverseOf(const Literal& element) const;
 
     bool isTrivialImage(const Literal& element) const;
     bool isTrivialInverse(const Literal& element) const;
 
+    // The lookup, shared with the symmetries of the solver
+    std::shared_ptr<const PermutationTable<Literal>> table() const {
+        return _lookup;
+    }
+
     int order() const;
     std::unique_ptr<Permutation> mult(int order) const;
 
@@ -46,8 +60,10 @@ class Permutation {
     std::vector<Literal> _cycles;
     std::vector<int> _cycles_lim;
 
-    std::unordered_map<Literal, Literal> _image;
-    std::unordered_map<Literal, Literal> _inverse;
+    // Lookup of images and inverses. closeCurrentCycle() only records the
+    // cycle, the table is built once by build(): building it cycle by cycle
+    // would be quadratic in the number of cycles.
+    std::shared_ptr<PermutationTable<Literal>> _lookup;
 
     DISALLOW_COPY_AND_ASSIGN(Permutation);
 };
@@ -69,6 +85,22 @@ struct Permutation::Iterator {
     int size() const { return _end - _begin; }
 };
 
+inline const Literal Permutation::imageOf(const Literal& element) const {
+    return _lookup->imageOf(element);
+}
+
+inline const Literal Permutation::inverseOf(const Literal& element) const {
+    return _lookup->inverseOf(element);
+}
+
+inline bool Permutation::isTrivialImage(const Literal& element) const {
+    return imageOf(element) == element;
+}
+
+inline bool Permutation::isTrivialInverse(const Literal& element) const {
+    return inverseOf(element) == element;
+}
+
 }  // namespace cosy
 
 #endif  // INCLUDE_COSY_PERMUTATION_H_
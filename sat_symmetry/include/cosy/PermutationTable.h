@@ -0,0 +1,215 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#ifndef INCLUDE_COSY_PERMUTATIONTABLE_H_
+#define INCLUDE_COSY_PERMUTATIONTABLE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "cosy/Literal.h"
+#include "cosy/Logging.h"
+
+namespace cosy {
+
+// Conversion between an element of a permutation and its integer index.
+// A solver using its own literal type provides the same two functions.
+template<class Element>
+struct ElementIndex {
+    static int index(const Element& element) {
+        return element.index().value();
+    }
+    static Element element(int index) { return Element(LiteralIndex(index)); }
+};
+
+// Image and inverse lookup of a permutation, used by cosy::Permutation and
+// by the symmetries of the solver. The memory is proportional to the
+// support: a support filling at least half of its index range is stored in
+// flat arrays over that range, other supports in arrays sorted by index
+// behind a bitmap filter of the range. Elements outside of the support are
+// their own image and inverse.
+template<class Element, class Index = ElementIndex<Element>>
+class PermutationTable {
+ public:
+    PermutationTable() :
+        _built(true), _dense(false), _min(0), _span(0), _shift(0) {}
+    ~PermutationTable() {}
+
+    // The mappings added are visible after the next build(), which CHECKs
+    // that the table describes a permutation: no element is mapped twice
+    // and the images of the support are the support.
+    void add(const Element& element, const Element& image);
+    void build();
+    bool isBuilt() const { return _built; }
+
+    Element imageOf(const Element& element) const;
+    Element inverseOf(const Element& element) const;
+
+    // Calls f(element, image) for each element of the support
+    template<class Function> void forEachMoved(Function f) const;
+
+ private:
+    static const unsigned int kDenseFactor = 2;
+    static const unsigned int kFilterBitsPerElement = 8;
+
+    std::vector<std::pair<int, int>> _pending;
+    bool _built;
+    bool _dense;
+    int _min;             // The support lies in [_min, _min + _span)
+    unsigned int _span;
+    unsigned int _shift;  // Bit i of the filter covers 2^_shift indexes
+    std::vector<uint64_t> _filter;
+    std::vector<int> _keys;
+    std::vector<Element> _image;
+    std::vector<Element> _inverse;
+
+    int position(const Element& element) const;
+};
+
+template<class Element, class Index>
+inline void PermutationTable<Element, Index>::add(const Element& element,
+                                                  const Element& image) {
+    _pending.emplace_back(Index::index(element), Index::index(image));
+    _built = false;
+}
+
+// Position of element in _image and _inverse, -1 if out of the support
+template<class Element, class Index>
+inline int
+PermutationTable<Element, Index>::position(const Element& element) const {
+    DCHECK(_built);
+    const int index = Index::index(element);
+    const unsigned int offset = static_cast<unsigned int>(index - _min);
+    if (offset >= _span)
+        return -1;
+    if (_dense)
+        return offset;
+
+    const unsigned int bit = offset >> _shift;
+    if (!((_filter[bit >> 6] >> (bit & 63)) & 1))
+        return -1;
+    const auto it = std::lower_bound(_keys.begin(), _keys.end(), index);
+    return (it != _keys.end() && *it == index) ? it - _keys.begin() : -1;
+}
+
+template<class Element, class Index>
+inline Element
+PermutationTable<Element, Index>::imageOf(const Element& element) const {
+    const int p = position(element);
+    return p < 0 ? element : _image[p];
+}
+
+template<class Element, class Index>
+inline Element
+PermutationTable<Element, Index>::inverseOf(const Element& element) const {
+    const int p = position(element);
+    return p < 0 ? element : _inverse[p];
+}
+
+template<class Element, class Index> template<class Function>
+inline void PermutationTable<Element, Index>::forEachMoved(Function f) const {
+    if (!_dense) {
+        for (unsigned int k = 0; k < _keys.size(); ++k)
+            f(Index::element(_keys[k]), _image[k]);
+        return;
+    }
+    for (unsigned int offset = 0; offset < _span; ++offset) {
+        const Element element = Index::element(_min + offset);
+        if (_image[offset] != element)
+            f(element, _image[offset]);
+    }
+}
+
+template<class Element, class Index>
+void PermutationTable<Element, Index>::build() {
+    if (_built)
+        return;
+
+    // Start again from the whole support
+    forEachMoved([this](const Element& element, const Element& image) {
+            _pending.emplace_back(Index::index(element), Index::index(image));
+        });
+    std::sort(_pending.begin(), _pending.end());
+
+    const unsigned int n = _pending.size();
+    _built = true;
+    _filter.clear();
+    _keys.clear();
+    if (n == 0) {
+        _dense = false;
+        _span = 0;
+        _image.clear();
+        _inverse.clear();
+        return;
+    }
+
+    std::vector<int> images(n);
+    for (unsigned int k = 0; k < n; ++k) {
+        if (k > 0)
+            CHECK_LT(_pending[k - 1].first, _pending[k].first);
+        images[k] = _pending[k].second;
+    }
+    std::sort(images.begin(), images.end());
+    for (unsigned int k = 0; k < n; ++k)
+        CHECK_EQ(images[k], _pending[k].first);
+
+    _min = _pending.front().first;
+    _span = _pending.back().first - _min + 1;
+    _dense = _span <= kDenseFactor * n;
+
+    if (_dense) {
+        _image.resize(_span);
+        _inverse.resize(_span);
+        for (unsigned int offset = 0; offset < _span; ++offset)
+            _image[offset] = _inverse[offset] = Index::element(_min + offset);
+        for (const std::pair<int, int>& mapping : _pending) {
+            DCHECK_LT(static_cast<unsigned int>(mapping.second - _min), _span);
+            _image[mapping.first - _min] = Index::element(mapping.second);
+            _inverse[mapping.second - _min] = Index::element(mapping.first);
+        }
+    } else {
+        _keys.resize(n);
+        _image.resize(n);
+        _inverse.resize(n);
+        for (unsigned int k = 0; k < n; ++k) {
+            _keys[k] = _pending[k].first;
+            _image[k] = Index::element(_pending[k].second);
+        }
+
+        // The images are the keys: in image order, the k-th mapping is the
+        // inverse of the k-th key
+        std::sort(_pending.begin(), _pending.end(),
+                  [](const std::pair<int, int>& a,
+                     const std::pair<int, int>& b) {
+                      return a.second < b.second;
+                  });
+        for (unsigned int k = 0; k < n; ++k) {
+            DCHECK_EQ(_pending[k].second, _keys[k]);
+            _inverse[k] = Index::element(_pending[k].first);
+        }
+
+        _shift = 0;
+        while (((_span - 1) >> _shift) >= kFilterBitsPerElement * n)
+            _shift++;
+        _filter.assign((((_span - 1) >> _shift) >> 6) + 1, 0);
+        for (const int key : _keys) {
+            const unsigned int bit = (key - _min) >> _shift;
+            _filter[bit >> 6] |= uint64_t(1) << (bit & 63);
+        }
+    }
+
+    _pending.clear();
+    _pending.shrink_to_fit();
+}
+
+}  // namespace cosy
+
+#endif  // INCLUDE_COSY_PERMUTATIONTABLE_H_
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
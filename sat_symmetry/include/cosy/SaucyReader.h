@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "cosy/Group.h"
 #include "cosy/Permutation.h"
@@ -17,6 +18,13 @@ class SaucyReader {
     SaucyReader() {}
     ~SaucyReader() {}
 
+    // Reads the generators of a Saucy file, built. Returns false and no
+    // generator when the file is not well formed or its cycles are not those
+    // of a permutation of the literals of num_vars variables.
+    bool read(const std::string& symmetry_filename, unsigned int num_vars,
+              std::vector<std::unique_ptr<Permutation>>* generators);
+
+    // Reads the generators then adds them to group, none on error
     bool load(const std::string& symmetry_filename, unsigned int num_vars,
               Group *group);
 };
@@ -0,0 +1,83 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#ifndef INCLUDE_COSY_SCHREIERSIMS_H_
+#define INCLUDE_COSY_SCHREIERSIMS_H_
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "cosy/IntegralTypes.h"
+#include "cosy/Macros.h"
+#include "cosy/Permutation.h"
+
+namespace cosy {
+
+// Stabilizer chain of the group generated by permutations of literals, to
+// get its order. The chain is built by the random Schreier-Sims algorithm:
+// random elements of the group are sifted through the chain, which is
+// extended by each element that does not sift to the identity, until
+// kTrials elements in a row do. The order is then exact with a probability
+// of at least 1 - 2^-kTrials, a divisor of the order otherwise.
+class SchreierSims {
+ public:
+    SchreierSims() : _num_points(0), _rng(0) {}
+    ~SchreierSims() {}
+
+    // Returns false, and no chain, when the chain would take more than
+    // max_words integers
+    bool build(const std::vector<std::unique_ptr<Permutation>>& generators,
+               int64 max_words);
+
+    // Decimal logarithm of the order, the sum of those of the orbit sizes
+    double log10Order() const;
+    unsigned int baseLength() const { return _levels.size(); }
+
+ private:
+    static const int kTrials = 32;
+    static const int kSlots = 10;
+    static const int kMixingSteps = 5;  // Per slot
+
+    typedef std::vector<int> Perm;
+
+    // Orbit of the base point under the strong generators fixing the
+    // previous base points: label[p] is the strong generator mapping the
+    // parent of p in the orbit tree to p, -1 out of the orbit.
+    struct Level {
+        int base;
+        std::vector<int> generators;
+        std::vector<int> label;
+        std::vector<int> orbit;
+    };
+
+    int _num_points;
+    int64 _max_words;
+    int64 _words;
+    std::vector<Perm> _strong;
+    std::vector<Perm> _inverses;
+    std::vector<Level> _levels;
+
+    std::mt19937 _rng;
+    std::vector<Perm> _slots;
+    Perm _accumulator;
+
+    int sift(Perm* g) const;
+    bool extend(const Perm& h, int level);
+    void growOrbit(Level* level, int generator);
+    Perm random();
+    static Perm inverse(const Perm& g);
+    static bool isIdentity(const Perm& g);
+
+    DISALLOW_COPY_AND_ASSIGN(SchreierSims);
+};
+
+}  // namespace cosy
+
+#endif  // INCLUDE_COSY_SCHREIERSIMS_H_
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
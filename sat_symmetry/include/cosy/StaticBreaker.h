@@ -0,0 +1,93 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#ifndef INCLUDE_COSY_STATICBREAKER_H_
+#define INCLUDE_COSY_STATICBREAKER_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cosy/CNFModel.h"
+#include "cosy/Group.h"
+#include "cosy/Literal.h"
+#include "cosy/Order.h"
+
+namespace cosy {
+
+// The lex-leader constraints of the generators of a group, as clauses added
+// to the problem before search, in the style of Shatter and BreakID. For a
+// generator, the literals x1 < x2 < ... of the order it moves are compared to
+// their inverse images y1, y2, ... as cosy does dynamically: an auxiliary
+// variable e(i) is implied when the first i pairs are equal, and each pair
+// is ordered, for the value order, when the previous ones are equal:
+//   e(i-1) -> x(i) <= y(i)
+//   e(i-1) & x(i) = y(i) -> e(i)
+// with three clauses per pair. Combined with cosy on the same order, both
+// keep the same lex-leader assignments. The auxiliary variables are numbered
+// after the variables of the problem.
+class StaticBreaker {
+ public:
+    StaticBreaker(const Group& group, const Order& order,
+                  unsigned int num_vars);
+    ~StaticBreaker();
+
+    // Pairs constrained per generator, the first ones of the order (0: all).
+    // The swaps of rows and columns of the matrices are not limited.
+    void setSizeLimit(unsigned int limit) { _size_limit = limit; }
+    // Only the swaps of rows and columns: their constraints are the lex
+    // chains that sort the rows and the columns of the matrices
+    void setMatricesOnly(bool enabled) { _matrices_only = enabled; }
+    void generate();
+
+    // Variables of the problem and auxiliary variables
+    unsigned int numberOfVariables() const {
+        return _num_vars + _num_auxiliary_vars;
+    }
+    unsigned int numberOfAuxiliaryVariables() const {
+        return _num_auxiliary_vars;
+    }
+    ClauseRange clauses() const {
+        return ClauseRange(_literals.data(), _clause_starts.data(),
+                           _clause_starts.size() - 1);
+    }
+
+    // The clauses of model then the breaking clauses, in DIMACS
+    bool write(const CNFModel& model, const std::string& filename) const;
+
+    void summarize() const;
+
+ private:
+    const Group& _group;
+    const Order& _order;
+    const unsigned int _num_vars;
+    unsigned int _size_limit;
+    bool _matrices_only;
+    unsigned int _num_auxiliary_vars;
+    unsigned int _num_truncated;
+
+    std::vector<Literal> _literals;
+    std::vector<int64> _clause_starts;
+
+    // Scratch of encode(): the variables compared for the generator, by
+    // stamp, and its pairs
+    std::vector<int> _compared;
+    int _stamp;
+    std::vector< std::pair<Literal, Literal> > _pairs;
+    std::vector<Literal> _clause;
+
+    void encode(const Permutation& generator,
+                const std::vector<Literal>& lookup, unsigned int size_limit);
+    Literal newAuxiliaryVariable();
+    void addClause();
+};
+
+}  // namespace cosy
+
+#endif  // INCLUDE_COSY_STATICBREAKER_H_
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
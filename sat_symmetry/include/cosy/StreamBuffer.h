@@ -6,15 +6,18 @@
 #include <zlib.h>
 
 #include <cctype>
+#include <memory>
 #include <string>
 
+#include "cosy/GzipReader.h"
 #include "cosy/Logging.h"
 #include "cosy/Literal.h"
 
-static const int kBufferSize = 4096;
-
 namespace cosy {
 
+// Character stream over a file. Uncompressed regular files are mapped in
+// memory and read in place, the others are decompressed by zlib through a
+// GzipReader.
 class StreamBuffer {
  public:
     explicit StreamBuffer(const std::string& filename);
@@ -31,10 +34,13 @@ class StreamBuffer {
  private:
     const std::string _filename;
     gzFile _in;
-    unsigned char _buffer[kBufferSize];
-    unsigned int _index;
-    unsigned int _size;
+    std::unique_ptr<GzipReader> _reader;
+    const unsigned char* _data;  // Buffer of _reader, or the mapped file
+    size_t _index;
+    size_t _size;
+    void* _mapped;
 
+    bool map(const char* filename);
     unsigned char read();
 };
 
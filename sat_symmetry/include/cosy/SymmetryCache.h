@@ -0,0 +1,68 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#ifndef INCLUDE_COSY_SYMMETRYCACHE_H_
+#define INCLUDE_COSY_SYMMETRYCACHE_H_
+
+#include <string>
+
+#include "cosy/CNFModel.h"
+#include "cosy/Group.h"
+#include "cosy/IntegralTypes.h"
+#include "cosy/Macros.h"
+#include "cosy/Stats.h"
+
+namespace cosy {
+
+// Directory of the generators found for CNF models, one Saucy file per
+// model and symmetry tool, named after the fingerprint of the model. An
+// identical instance, up to the order of its clauses and of their literals,
+// gets its generators back without building its graph. The least recently
+// used entries are evicted beyond max_bytes. The hits, misses and
+// evictions of all the runs sharing the directory are kept in its file
+// "stats".
+class SymmetryCache {
+ public:
+    SymmetryCache(const std::string& directory, int64 max_bytes);
+    ~SymmetryCache() {}
+
+    // Adds the generators of model to group, returns false on a miss. An
+    // entry which is not valid for model is a miss and adds nothing.
+    bool lookup(const CNFModel& model, int tool, unsigned int num_vars,
+                Group* group);
+    void store(const CNFModel& model, int tool, unsigned int num_vars,
+               const Group& group);
+
+    void printStats() const;
+
+ private:
+    const std::string _directory;
+    const int64 _max_bytes;
+
+    std::string entry(const CNFModel& model, int tool) const;
+    void evict();
+    void addToTotals(int64 hits, int64 misses, int64 evictions);
+
+    struct Stats : public StatsGroup {
+        Stats() : StatsGroup("Symmetry Cache"),
+                  hits("Cache hits", this),
+                  misses("Cache misses", this),
+                  evictions("Cache evictions", this) {}
+        CounterStat hits;
+        CounterStat misses;
+        CounterStat evictions;
+    };
+    Stats _stats;
+
+    DISALLOW_COPY_AND_ASSIGN(SymmetryCache);
+};
+
+}  // namespace cosy
+
+#endif  // INCLUDE_COSY_SYMMETRYCACHE_H_
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
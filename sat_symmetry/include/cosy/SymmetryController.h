@@ -15,9 +15,12 @@
 #include "cosy/Group.h"
 #include "cosy/LiteralAdapter.h"
 #include "cosy/Logging.h"
+#include "cosy/Matrixes.h"
 #include "cosy/OrderFactory.h"
 #include "cosy/Printer.h"
 #include "cosy/SaucyReader.h"
+#include "cosy/StaticBreaker.h"
+#include "cosy/SymmetryCache.h"
 #include "cosy/SymmetryFinder.h"
 
 
@@ -34,18 +37,73 @@ class SymmetryController {
                        SymmetryFinder::Automorphism tool,
                        std::unique_ptr<LiteralAdapter<T>>&& adapter);
 
+    // The CNF model is not read from a file but fed clause by clause with
+    // addClause() while the caller parses the problem, then completed by
+    // loadSymmetries().
+    explicit SymmetryController(std::unique_ptr<LiteralAdapter<T>>&& adapter);
+
     virtual ~SymmetryController() {}
 
+    // Sizes of the problem, if known before its clauses
+    void reserve(int64 num_vars, int64 num_clauses) {
+        _cnf_model.reserve(num_vars, num_clauses);
+    }
+    template<class Container> void addClause(const Container& literals_s);
+    bool loadSymmetries(const std::string& symmetry_filename);
+    bool findSymmetries(SymmetryFinder::Automorphism tool);
+    // Limits the search of findSymmetries(), which then keeps the
+    // generators found before the budget is exhausted.
+    void setFinderBudget(const SymmetryFinder::Budget& budget) {
+        _finder_budget = budget;
+    }
+    // False if findSymmetries() stopped on its budget
+    bool symmetriesComplete() const {
+        return !_symmetry_finder || _symmetry_finder->complete();
+    }
+    // Keeps the generators found by findSymmetries() in directory, to
+    // reuse them for the same CNF model.
+    void enableSymmetryCache(const std::string& directory, int64 max_bytes);
+    // Completes the CNF model with generators known by the caller, e.g.
+    // found by an earlier run, each given by its cycles.
+    void loadSymmetries(
+        const std::vector<std::vector<std::vector<T>>>& generators);
+
+    const Group& group() const { return _group; }
+    T convertFrom(Literal literal_c) const {
+        return _literal_adapter->convertFrom(literal_c);
+    }
+
+    // Before enableCosy() and enableStaticBreaking(): the matrices of
+    // interchangeable rows found in the group have their rows and columns
+    // sorted by cosy and the static breaking (off by default)
+    void setMatrixDetection(bool enabled) { _matrix_detection = enabled; }
     void enableCosy(OrderMode vars, ValueMode value);
 
+    // Before search: the lex-leader constraints of the generators as clauses,
+    // for the order cosy uses with the same modes, or only those of the swaps
+    // of the matrices. Their auxiliary variables are not seen by cosy.
+    void enableStaticBreaking(OrderMode vars, ValueMode value,
+                              unsigned int size_limit,
+                              bool matrices_only = false);
+    const StaticBreaker* staticBreaker() const { return _static_breaker.get(); }
+    // The CNF model, without duplicate clauses, then the static breaking
+    bool writeStaticBreaking(const std::string& filename) const {
+        return _static_breaker && _static_breaker->write(_cnf_model, filename);
+    }
+
     void updateNotify(T literal_s);
     void updateCancel(T literal_s);
+    void newDecisionLevel();
+    void cancelUntil(int level);
 
     bool hasClauseToInject(ClauseInjector::Type type, T literal_s) const;
     std::vector<T> clauseToInject(ClauseInjector::Type type, T literal_s);
+    void clauseToInject(ClauseInjector::Type type, T literal_s,
+                        std::vector<T>* literals_s);
 
     bool hasClauseToInject(ClauseInjector::Type type) const;
     std::vector<T> clauseToInject(ClauseInjector::Type type);
+    void clauseToInject(ClauseInjector::Type type, std::vector<T>* literals_s);
 
     void printInfo() const;
     void printStats() const;
@@ -59,9 +117,20 @@ class SymmetryController {
     ClauseInjector _injector;
     std::unique_ptr<CosyManager> _cosy_manager;
     std::unique_ptr<SymmetryFinder> _symmetry_finder;
+    std::unique_ptr<SymmetryCache> _symmetry_cache;
+    std::unique_ptr<Matrixes> _matrixes;
+    bool _matrix_detection;
+    std::unique_ptr<Order> _static_order;
+    std::unique_ptr<StaticBreaker> _static_breaker;
+    SymmetryFinder::Budget _finder_budget;
+    std::vector<Literal> _clause_buffer;
 
     bool loadCNFProblem(const std::string cnf_filename);
+    void closeCNFProblem();
+    void detectMatrixes();
     std::vector<T> adaptVector(const std::vector<Literal>& literals);
+    void adaptVector(const ClauseView& literals,
+                     std::vector<T>* adapted);
 };
 
 // Implementation
@@ -76,12 +145,18 @@ bool SymmetryController<T>::loadCNFProblem(const std::string cnf_filename) {
         LOG(ERROR) << "CNF file " << cnf_filename << " is not well formed.";
         return false;
     }
-    _num_vars = _cnf_model.numberOfVariables();
-    _assignment.resize(_num_vars);
+    closeCNFProblem();
 
     return true;
 }
 
+template<class T> inline
+void SymmetryController<T>::closeCNFProblem() {
+    _num_vars = _cnf_model.numberOfVariables();
+    _assignment.resize(_num_vars);
+    _injector.resize(_num_vars);
+}
+
 
 template<class T>
 inline SymmetryController<T>::SymmetryController(
@@ -90,7 +165,12 @@ inline SymmetryController<T>::SymmetryController(
                            std::unique_ptr<LiteralAdapter<T>>&& adapter) :
     _literal_adapter(std::move(adapter)),
     _cosy_manager(nullptr),
-    _symmetry_finder(nullptr) {
+    _symmetry_finder(nullptr),
+    _symmetry_cache(nullptr),
+    _matrixes(nullptr),
+    _matrix_detection(false),
+    _static_order(nullptr),
+    _static_breaker(nullptr) {
     bool success;
     SaucyReader sym_reader;
 
@@ -109,17 +189,102 @@ inline SymmetryController<T>::SymmetryController(
                             std::unique_ptr<LiteralAdapter<T>>&& adapter) :
     _literal_adapter(std::move(adapter)),
     _cosy_manager(nullptr),
-    _symmetry_finder(nullptr) {
+    _symmetry_finder(nullptr),
+    _symmetry_cache(nullptr),
+    _matrixes(nullptr),
+    _matrix_detection(false),
+    _static_order(nullptr),
+    _static_breaker(nullptr) {
     if (!loadCNFProblem(cnf_filename))
         return;
 
+    findSymmetries(tool);
+}
+
+template<class T>
+inline SymmetryController<T>::SymmetryController(
+                           std::unique_ptr<LiteralAdapter<T>>&& adapter) :
+    _num_vars(0),
+    _literal_adapter(std::move(adapter)),
+    _cosy_manager(nullptr),
+    _symmetry_finder(nullptr),
+    _symmetry_cache(nullptr),
+    _matrixes(nullptr),
+    _matrix_detection(false),
+    _static_order(nullptr),
+    _static_breaker(nullptr) {
+}
+
+template<class T> template<class Container>
+inline void SymmetryController<T>::addClause(const Container& literals_s) {
+    // The empty clause says nothing about the symmetries
+    if (literals_s.size() == 0)
+        return;
+
+    _clause_buffer.clear();
+    for (int i = 0; i < static_cast<int>(literals_s.size()); i++)
+        _clause_buffer.push_back(_literal_adapter->convertTo(literals_s[i]));
+    _cnf_model.addClause(&_clause_buffer);
+}
+
+template<class T> inline bool
+SymmetryController<T>::loadSymmetries(const std::string& sym_filename) {
+    SaucyReader sym_reader;
+
+    closeCNFProblem();
+
+    if (!sym_reader.load(sym_filename, _num_vars, &_group)) {
+        LOG(ERROR) << "Saucy file " << sym_filename << " is not well formed.";
+        return false;
+    }
+    return true;
+}
+
+template<class T> inline bool
+SymmetryController<T>::findSymmetries(SymmetryFinder::Automorphism tool) {
+    closeCNFProblem();
+
+    if (_symmetry_cache &&
+        _symmetry_cache->lookup(_cnf_model, tool, _num_vars, &_group))
+        return true;
+
     _symmetry_finder = std::unique_ptr<SymmetryFinder>
         (SymmetryFinder::create(_cnf_model, tool));
-
-    CHECK_NOTNULL(_symmetry_finder);
+    if (_symmetry_finder == nullptr) {
+        LOG(ERROR) << "Unknown automorphism tool " << tool;
+        return false;
+    }
+    _symmetry_finder->setBudget(_finder_budget);
     _symmetry_finder->findAutomorphism(&_group);
 
-    // _group.augmentAll();
+    // A partial group is not kept: a run with a larger budget may do better
+    if (_symmetry_cache && _symmetry_finder->complete())
+        _symmetry_cache->store(_cnf_model, tool, _num_vars, _group);
+
+    return true;
+}
+
+template<class T> inline void
+SymmetryController<T>::enableSymmetryCache(const std::string& directory,
+                                           int64 max_bytes) {
+    _symmetry_cache = std::unique_ptr<SymmetryCache>
+        (new SymmetryCache(directory, max_bytes));
+}
+
+template<class T> inline void SymmetryController<T>::loadSymmetries(
+                const std::vector<std::vector<std::vector<T>>>& generators) {
+    closeCNFProblem();
+
+    for (const std::vector<std::vector<T>>& cycles : generators) {
+        std::unique_ptr<Permutation> generator(new Permutation(_num_vars));
+        for (const std::vector<T>& cycle : cycles) {
+            for (const T& literal_s : cycle)
+                generator->addToCurrentCycle(
+                    _literal_adapter->convertTo(literal_s));
+            generator->closeCurrentCycle();
+        }
+        _group.addPermutation(std::move(generator));
+    }
 }
 
 template<class T>
@@ -127,8 +292,11 @@ inline void SymmetryController<T>::enableCosy(OrderMode vars, ValueMode value) {
     if (_group.numberOfPermutations() == 0)
         return;
 
+    detectMatrixes();
+
     std::unique_ptr<Order> order
-        (OrderFactory::create(vars, value, _cnf_model, _group));
+        (OrderFactory::create(vars, value, _cnf_model, _group,
+                              _matrixes.get()));
     CHECK_NOTNULL(order);
 
     _cosy_manager = std::unique_ptr<CosyManager>
@@ -138,9 +306,39 @@ inline void SymmetryController<T>::enableCosy(OrderMode vars, ValueMode value) {
     _cosy_manager->generateUnits(&_injector);
 }
 
+template<class T> inline void
+SymmetryController<T>::enableStaticBreaking(OrderMode vars, ValueMode value,
+                                           unsigned int size_limit,
+                                           bool matrices_only) {
+    detectMatrixes();
+
+    _static_order = std::unique_ptr<Order>
+        (OrderFactory::create(vars, value, _cnf_model, _group,
+                              _matrixes.get()));
+    CHECK_NOTNULL(_static_order);
+
+    _static_breaker = std::unique_ptr<StaticBreaker>
+        (new StaticBreaker(_group, *_static_order, _num_vars));
+    _static_breaker->setSizeLimit(size_limit);
+    _static_breaker->setMatricesOnly(matrices_only);
+    _static_breaker->generate();
+}
+
+template<class T>
+inline void SymmetryController<T>::detectMatrixes() {
+    if (!_matrix_detection || _matrixes != nullptr)
+        return;
+
+    _matrixes = std::unique_ptr<Matrixes>(new Matrixes(_cnf_model));
+    _matrixes->detect(_group);
+    _matrixes->augment(&_group);
+}
+
 template<class T>
 inline void SymmetryController<T>::updateNotify(T literal_s) {
     cosy::Literal literal_c = _literal_adapter->convertTo(literal_s);
+    if (literal_c.variable() >= _num_vars)
+        return;
     _assignment.assignFromTrueLiteral(literal_c);
     if (_cosy_manager)
         _cosy_manager->updateNotify(literal_c, &_injector);
@@ -150,21 +348,33 @@ template<class T>
 inline void SymmetryController<T>::updateCancel(T literal_s) {
     cosy::Literal literal_c = _literal_adapter->convertTo(literal_s);
 
-    if (!_assignment.literalIsAssigned(literal_c))
+    if (literal_c.variable() >= _num_vars ||
+        !_assignment.literalIsAssigned(literal_c))
         return;
 
     _assignment.unassignLiteral(literal_c);
 
+    // _injector.removeClause(literal_c.variable());
+}
+
+template<class T>
+inline void SymmetryController<T>::newDecisionLevel() {
     if (_cosy_manager)
-        _cosy_manager->updateCancel(literal_c);
+        _cosy_manager->newDecisionLevel();
+}
 
-    // _injector.removeClause(literal_c.variable());
+template<class T>
+inline void SymmetryController<T>::cancelUntil(int level) {
+    if (_cosy_manager)
+        _cosy_manager->cancelUntil(level);
 }
 
 template<class T> inline bool
 SymmetryController<T>::hasClauseToInject(ClauseInjector::Type type,
                                          T literal_s) const {
     cosy::Literal literal_c = _literal_adapter->convertTo(literal_s);
+    if (literal_c.variable() >= _num_vars)
+        return false;
     return _injector.hasClause(type, literal_c.variable());
 }
 
@@ -178,6 +388,13 @@ SymmetryController<T>::clauseToInject(ClauseInjector::Type type, T literal_s) {
     return literals_s;
 }
 
+template<class T> inline void
+SymmetryController<T>::clauseToInject(ClauseInjector::Type type, T literal_s,
+                                      std::vector<T>* literals_s) {
+    cosy::Literal literal_c =  _literal_adapter->convertTo(literal_s);
+    adaptVector(_injector.takeClause(type, literal_c.variable()), literals_s);
+}
+
 template<class T> inline bool
 SymmetryController<T>::hasClauseToInject(ClauseInjector::Type type) const {
     return _injector.hasClause(type, kNoBooleanVariable);
@@ -191,6 +408,12 @@ SymmetryController<T>::clauseToInject(ClauseInjector::Type type) {
     return literals_s;
 }
 
+template<class T> inline void
+SymmetryController<T>::clauseToInject(ClauseInjector::Type type,
+                                      std::vector<T>* literals_s) {
+    adaptVector(_injector.takeClause(type, kNoBooleanVariable), literals_s);
+}
+
 
 template<class T> inline std::vector<T>
 SymmetryController<T>::adaptVector(const std::vector<Literal>& literals) {
@@ -201,6 +424,14 @@ SymmetryController<T>::adaptVector(const std::vector<Literal>& literals) {
     return std::move(adapted);
 }
 
+template<class T> inline void
+SymmetryController<T>::adaptVector(const ClauseView& literals,
+                                   std::vector<T>* adapted) {
+    adapted->clear();
+    for (const Literal& literal : literals)
+        adapted->push_back(_literal_adapter->convertFrom(literal));
+}
+
 template<class T> inline void
 SymmetryController<T>::printStats() const {
     Printer::printSection(" Symmetry Stats ");
@@ -216,7 +447,13 @@ SymmetryController<T>::printInfo() const {
     Printer::printSection(" Symmetry Information ");
     if (_symmetry_finder)
         _symmetry_finder->printStats();
+    if (_symmetry_cache)
+        _symmetry_cache->printStats();
     _group.summarize(_num_vars);
+    if (_matrixes)
+        _matrixes->summarize();
+    if (_static_breaker)
+        _static_breaker->summarize();
     if (_cosy_manager)
         _cosy_manager->summarize();
 }
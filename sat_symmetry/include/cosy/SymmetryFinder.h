@@ -3,8 +3,13 @@
 #ifndef INCLUDE_COSY_SYMMETRYFINDER_H_
 #define INCLUDE_COSY_SYMMETRYFINDER_H_
 
+#include <time.h>
+
+#include <atomic>
+#include <memory>
 #include <string>
 
+#include "cosy/AutomorphismChecker.h"
 #include "cosy/CNFModel.h"
 #include "cosy/CNFGraph.h"
 #include "cosy/Group.h"
@@ -13,12 +18,17 @@
 
 namespace cosy {
 
+class SymmetryFinder;
+
 struct SymmetryFinderInfo {
-    explicit SymmetryFinderInfo(Group *g, unsigned int n) :
+    explicit SymmetryFinderInfo(Group *g, unsigned int n,
+                                SymmetryFinder *f = nullptr) :
         group(g),
-        num_vars(n) {}
+        num_vars(n),
+        finder(f) {}
     Group *group;
     unsigned int num_vars;
+    SymmetryFinder *finder;
 };
 
 class SymmetryFinder {
@@ -28,6 +38,20 @@ class SymmetryFinder {
         SAUCY,
     };
 
+    // Limits of the search of findAutomorphism(), 0 for no limit. When a
+    // limit is reached the search stops and the group holds the generators
+    // found so far, which generate a subgroup of the automorphism group.
+    // The seconds are CPU time of the process, which grows with the number
+    // of searching threads as the limits of setrlimit() do.
+    struct Budget {
+        Budget() : seconds(0), nodes(0), generators(0), threads(0) {}
+        double seconds;
+        int64 nodes;
+        int64 generators;
+        // Searching threads, 0 for one per core
+        unsigned int threads;
+    };
+
     virtual ~SymmetryFinder() {}
 
     virtual void findAutomorphism(Group *group) = 0;
@@ -36,8 +60,32 @@ class SymmetryFinder {
     static SymmetryFinder* create(const CNFModel& model,
                                   SymmetryFinder::Automorphism tool);
 
+    void setBudget(const Budget& budget) { _budget = budget; }
+    // False if the last search was stopped by the budget
+    bool complete() const { return _stop_reason == nullptr; }
+
+    // Called by the automorphism tool before each node of its search tree,
+    // and regularly while it builds its graph and initial partition. They
+    // can be called from several threads searching at the same time.
+    bool budgetExhausted();
+    bool timeExhausted();
+    void generatorFound() { _generators++; }
+
+    // Adds the generator found by the tool to group if it is an
+    // automorphism of the model, counts it as rejected otherwise. Called by
+    // one thread at a time.
+    void addGenerator(Group *group, std::unique_ptr<Permutation>&& generator);
+
     void printStats() const {
         Printer::printStat("Automorhism tool", toolName());
+        Printer::printStat("Automorphism search", complete() ?
+                           "complete" : std::string("partial, ") +
+                           _stop_reason.load() + " budget exhausted");
+        Printer::printStat("Automorphism search nodes", _nodes.load());
+        Printer::printStat("Automorphism graph memory",
+                           _graph.memoryUsage() / 1048576.0, "MB");
+        Printer::printStat("Automorphism peak memory", _peak_memory, "MB");
+        Printer::printStat("Generators rejected", _rejected);
         _stats.print();
     }
 
@@ -45,19 +93,89 @@ class SymmetryFinder {
     unsigned int _num_vars;
     CNFGraph _graph;
 
-    explicit SymmetryFinder(const CNFModel& model) {
+    explicit SymmetryFinder(const CNFModel& model) :
+        _model(model),
+        _rejected(0),
+        _nodes(0),
+        _generators(0),
+        _stop_reason(nullptr),
+        _peak_memory(0) {
         _num_vars = model.numberOfVariables();
         _graph.assign(model);
     }
 
+    // To call at the start and at the end of findAutomorphism()
+    void startSearch();
+    void endSearch();
+
+    unsigned int numberOfThreads() const { return _budget.threads; }
+
     struct Stats : public StatsGroup {
         Stats() : StatsGroup("Symmetry Finder"),
                   find_time("Automorphism time", this) {}
         TimeDistribution find_time;
     };
     Stats _stats;
+
+ private:
+    const CNFModel& _model;
+    // Built on the first generator
+    std::unique_ptr<AutomorphismChecker> _checker;
+    int64 _rejected;
+    Budget _budget;
+    double _deadline;
+    std::atomic<int64> _nodes;
+    std::atomic<int64> _generators;
+    std::atomic<const char*> _stop_reason;
+    double _peak_memory;
+
+    bool stop(const char *reason);
+    static double processTime();
 };
 
+inline double SymmetryFinder::processTime() {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+inline void SymmetryFinder::startSearch() {
+    _rejected = 0;
+    _nodes = 0;
+    _generators = 0;
+    _stop_reason = nullptr;
+    _deadline = processTime() + _budget.seconds;
+}
+
+// The first budget exhausted is the one reported
+inline bool SymmetryFinder::stop(const char *reason) {
+    const char *none = nullptr;
+    _stop_reason.compare_exchange_strong(none, reason);
+    return true;
+}
+
+inline bool SymmetryFinder::budgetExhausted() {
+    if (_stop_reason != nullptr)
+        return true;
+    if (_budget.nodes > 0 && _nodes >= _budget.nodes)
+        return stop("node");
+    if (_budget.generators > 0 && _generators >= _budget.generators)
+        return stop("generator");
+    if (timeExhausted())
+        return true;
+
+    _nodes++;
+    return false;
+}
+
+inline bool SymmetryFinder::timeExhausted() {
+    if (_stop_reason != nullptr)
+        return true;
+    if (_budget.seconds > 0 && processTime() >= _deadline)
+        return stop("time");
+    return false;
+}
+
 }  // namespace cosy
 
 #endif  // INCLUDE_COSY_SYMMETRYFINDER_H_
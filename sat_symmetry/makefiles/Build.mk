@@ -30,7 +30,7 @@ default: $(LIB)$(lib)
 # TESTS
 
 test : CFLAGS  += -O0 -D DEBUG -g -fprofile-arcs -ftest-coverage
-test : LDFLAGS += -lgtest -lgtest_main -lpthread -lbliss -lsaucy -lgcov
+test : LDFLAGS += -lgtest -lgtest_main -lpthread -lbliss -lgcov
 
 test: $(BIN)test
 run-test: test
@@ -14,11 +14,11 @@ $(call REQUIRE-DIR, $(BIN)minisat-release)
 $(call REQUIRE-DIR, $(BIN)minisat-simp)
 $(call REQUIRE-DIR, $(BIN)minisat-simp-release)
 
-$(BIN)CNFBlissSymmetries: LDFLAGS += -lcosy -lbliss  -lz
+$(BIN)CNFBlissSymmetries: LDFLAGS += -lcosy -lbliss  -lz -pthread
 $(BIN)CNFBlissSymmetries: $(EXAMPLES)CNFBlissSymmetries.cc
 	$(call cmd-cxx-bin, $@, $<, $(LDFLAGS))
 
-$(BIN)CNFSaucySymmetries: LDFLAGS += -lcosy -lsaucy  -lz
+$(BIN)CNFSaucySymmetries: LDFLAGS += -lcosy -lbliss  -lz -pthread
 $(BIN)CNFSaucySymmetries: $(EXAMPLES)CNFSaucySymmetries.cc
 	$(call cmd-cxx-bin, $@, $<, $(LDFLAGS))
 
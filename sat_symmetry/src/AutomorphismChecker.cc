@@ -0,0 +1,70 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include "cosy/AutomorphismChecker.h"
+
+#include <algorithm>
+
+namespace cosy {
+
+AutomorphismChecker::AutomorphismChecker(const CNFModel& model,
+                                         unsigned int num_vars) :
+    _model(model),
+    _stamp(0) {
+    const int64 num_literals = 2 * static_cast<int64>(num_vars);
+    _occurence_starts.assign(num_literals + 1, 0);
+    for (const ClauseView clause : _model.clauses())
+        for (const Literal& literal : clause)
+            if (literal.index().value() < num_literals)
+                _occurence_starts[literal.index().value() + 1]++;
+    for (int64 i = 0; i < num_literals; ++i)
+        _occurence_starts[i + 1] += _occurence_starts[i];
+
+    std::vector<int64> next(_occurence_starts.begin(),
+                            _occurence_starts.end() - 1);
+    _occurence_clauses.resize(_occurence_starts[num_literals]);
+    int64 k = 0;
+    for (const ClauseView clause : _model.clauses()) {
+        for (const Literal& literal : clause)
+            if (literal.index().value() < num_literals)
+                _occurence_clauses[next[literal.index().value()]++] = k;
+        k++;
+    }
+    _checked.assign(k, 0);
+}
+
+// The clauses are distinct: mapping each of them to a clause maps the set
+// of clauses onto itself.
+bool AutomorphismChecker::isAutomorphism(const Permutation& permutation) {
+    const int64 num_literals = _occurence_starts.size() - 1;
+
+    _stamp++;
+    for (const Literal& x : permutation.support()) {
+        const int64 index = x.index().value();
+        if (index >= num_literals)
+            continue;
+        for (int64 j = _occurence_starts[index];
+             j < _occurence_starts[index + 1]; ++j) {
+            const int64 k = _occurence_clauses[j];
+            if (_checked[k] == _stamp)
+                continue;
+            _checked[k] = _stamp;
+
+            _mapped.clear();
+            for (const Literal& y : _model.clause(k))
+                _mapped.push_back(permutation.imageOf(y));
+            std::sort(_mapped.begin(), _mapped.end());
+            if (!_model.hasClause(_mapped))
+                return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
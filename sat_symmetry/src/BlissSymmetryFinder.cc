@@ -2,6 +2,12 @@
 
 #include "cosy/BlissSymmetryFinder.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
 #include "bliss/graph.hh"
 
 namespace cosy {
@@ -33,12 +39,152 @@ on_automorphim(void* arg, const unsigned int n, const unsigned int* aut) {
         }
         permutation->closeCurrentCycle();
     }
-    group->addPermutation(std::move(permutation));
+    info->finder->addGenerator(group, std::move(permutation));
+    info->finder->generatorFound();
+}
+
+static bool on_search_step(void* arg, bool in_search) {
+    SymmetryFinderInfo *info = static_cast<SymmetryFinderInfo*>(arg);
+    if (in_search)
+        return info->finder->budgetExhausted();
+    return info->finder->timeExhausted();
 }
 
+namespace {
+
+// Search of one connected component in a bliss graph of its own. Its
+// generators are kept as cycles of nodes of the whole graph, to be added to
+// the group in the order of the components whatever the order of the
+// searches. A component sharing its invariants with another one is given a
+// canonical form, to detect the isomorphic components.
+struct ComponentSearch {
+    explicit ComponentSearch(const std::vector<unsigned int>* n,
+                             SymmetryFinder *f) :
+        nodes(n),
+        finder(f),
+        canonical(false),
+        stopped(false) {}
+
+    const std::vector<unsigned int>* nodes;
+    SymmetryFinder *finder;
+    bool canonical;
+    bool stopped;
+    std::vector<std::vector<std::vector<unsigned int>>> generators;
+    // Canonical position of the nodes, and the colors then the edges of the
+    // component in canonical positions
+    std::vector<unsigned int> labeling;
+    std::vector<unsigned int> certificate;
+    uint64 hash;
+};
+
+void on_component_automorphism(void* arg, const unsigned int n,
+                               const unsigned int* aut) {
+    ComponentSearch *search = static_cast<ComponentSearch*>(arg);
+    const std::vector<unsigned int>& nodes = *search->nodes;
+    std::vector<bool> seen(n);
+
+    search->finder->generatorFound();
+    search->generators.emplace_back();
+    for (unsigned int i = 0; i < n; ++i) {
+        if (i == aut[i] || seen[i])
+            continue;
+        search->generators.back().emplace_back();
+        std::vector<unsigned int>& cycle = search->generators.back().back();
+        for (unsigned int j = i; !seen[j]; j = aut[j]) {
+            seen[j] = true;
+            cycle.push_back(nodes[j]);
+        }
+    }
+}
+
+bool on_component_step(void* arg, bool in_search) {
+    ComponentSearch *search = static_cast<ComponentSearch*>(arg);
+    const bool stop = in_search ? search->finder->budgetExhausted() :
+        search->finder->timeExhausted();
+    search->stopped = search->stopped || stop;
+    return stop;
+}
+
+void searchComponent(const CNFGraph& graph,
+                     const std::vector<unsigned int>& local,
+                     ComponentSearch *search) {
+    const std::vector<unsigned int>& nodes = *search->nodes;
+    const unsigned int n = nodes.size();
+
+    bliss::Graph g(n);
+    std::vector<unsigned int> row;
+    for (unsigned int i = 0; i < n; i++) {
+        g.change_color(i, graph.color(nodes[i]));
+        row.clear();
+        for (const unsigned int x : graph.neighbour(nodes[i]))
+            row.push_back(local[x]);
+        g.add_edges(i, row.data(), row.data() + row.size());
+    }
+
+    bliss::Stats stats;
+    if (!search->canonical) {
+        g.find_automorphisms(stats, &on_component_automorphism,
+                             static_cast<void*>(search), &on_component_step);
+        return;
+    }
+
+    const unsigned int* labeling =
+        g.canonical_form(stats, &on_component_automorphism,
+                         static_cast<void*>(search), &on_component_step);
+    if (search->stopped)
+        return;
+    search->labeling.assign(labeling, labeling + n);
+
+    std::vector<std::pair<unsigned int, unsigned int>> edges;
+    search->certificate.resize(n);
+    for (unsigned int i = 0; i < n; i++) {
+        search->certificate[labeling[i]] = graph.color(nodes[i]);
+        for (const unsigned int x : graph.neighbour(nodes[i]))
+            if (nodes[i] < x)
+                edges.push_back(std::minmax(labeling[i], labeling[local[x]]));
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    for (const std::pair<unsigned int, unsigned int>& edge : edges) {
+        search->certificate.push_back(edge.first);
+        search->certificate.push_back(edge.second);
+    }
+
+    search->hash = 0;
+    for (const unsigned int x : search->certificate)
+        search->hash = (search->hash ^ x) * 0x100000001B3ULL;
+}
+
+// Invariant of a component under isomorphism: its size, its degrees and its
+// colors
+uint64 componentInvariant(const CNFGraph& graph,
+                          const std::vector<unsigned int>& nodes) {
+    uint64 sum = nodes.size();
+    for (const unsigned int node : nodes) {
+        uint64 x = (static_cast<uint64>(graph.color(node)) << 32) ^
+            graph.degree(node);
+        x *= 0x9E3779B97F4A7C15ULL;
+        sum += x ^ (x >> 29);
+    }
+    return sum;
+}
+
+}  // namespace
+
 void BlissSymmetryFinder::findAutomorphism(Group *group) {
     SCOPED_TIME_STAT(&_stats.find_time);
+    startSearch();
 
+    const std::vector<std::vector<unsigned int>> components =
+        _graph.components();
+    if (components.size() > 1)
+        searchComponents(group, components);
+    else
+        searchGraph(group);
+    endSearch();
+}
+
+void BlissSymmetryFinder::searchGraph(Group *group) {
     unsigned int n = _graph.numberOfNodes();
 
     std::unique_ptr<bliss::Graph> g(new bliss::Graph(n));
@@ -47,14 +193,116 @@ void BlissSymmetryFinder::findAutomorphism(Group *group) {
     for (unsigned int i = 0; i < n; i++)
         g->change_color(i, _graph.color(i));
 
-    for (unsigned int i = 0; i < n; i++)
-        for (const unsigned int& x : _graph.neighbour(i))
-            g->add_edge(i, x);
+    for (unsigned int i = 0; i < n; i++) {
+        if ((i & 1023) == 0 && timeExhausted())
+            return;
+        const Neighbours neighbours = _graph.neighbour(i);
+        g->add_edges(i, neighbours.begin(), neighbours.end());
+    }
 
-    SymmetryFinderInfo info(group, _num_vars);
+    SymmetryFinderInfo info(group, _num_vars, this);
 
-    g->find_automorphisms(stats, &on_automorphim, static_cast<void*>(&info));
+    g->find_automorphisms(stats, &on_automorphim, static_cast<void*>(&info),
+                          &on_search_step);
 }
 
+void BlissSymmetryFinder::searchComponents(Group *group,
+                        const std::vector<std::vector<unsigned int>>& cs) {
+    std::vector<unsigned int> local(_graph.numberOfNodes());
+    std::vector<unsigned int> color_count;
+    for (const std::vector<unsigned int>& nodes : cs)
+        for (unsigned int i = 0; i < nodes.size(); i++) {
+            local[nodes[i]] = i;
+            if (_graph.color(nodes[i]) >= color_count.size())
+                color_count.resize(_graph.color(nodes[i]) + 1, 0);
+            color_count[_graph.color(nodes[i])]++;
+        }
+
+    // A component whose colors are all unique in the graph is fixed by all
+    // the automorphisms, e.g. an unused variable
+    std::vector<ComponentSearch> searches;
+    std::unordered_map<uint64, int> invariants;
+    for (const std::vector<unsigned int>& nodes : cs) {
+        bool rigid = true;
+        for (const unsigned int node : nodes)
+            rigid = rigid && color_count[_graph.color(node)] == 1;
+        if (rigid)
+            continue;
+        searches.emplace_back(&nodes, this);
+        invariants[componentInvariant(_graph, nodes)]++;
+    }
+    for (ComponentSearch& search : searches)
+        search.canonical =
+            invariants[componentInvariant(_graph, *search.nodes)] > 1;
+
+    // Largest components first, to balance the threads
+    std::vector<unsigned int> order(searches.size());
+    for (unsigned int i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&searches](unsigned int a, unsigned int b) {
+                         return searches[a].nodes->size() >
+                             searches[b].nodes->size();
+                     });
+
+    std::atomic<unsigned int> next(0);
+    auto worker = [&]() {
+        for (unsigned int i = next++; i < order.size(); i = next++)
+            searchComponent(_graph, local, &searches[order[i]]);
+    };
+    const unsigned int num_threads = std::min<size_t>(
+        numberOfThreads() > 0 ? numberOfThreads() :
+        std::max(1u, std::thread::hardware_concurrency()), searches.size());
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < num_threads; t++)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::vector<std::vector<std::vector<unsigned int>>> generators;
+    for (const ComponentSearch& search : searches)
+        generators.insert(generators.end(), search.generators.begin(),
+                          search.generators.end());
+
+    // Isomorphic components are interchanged: each one with the next one of
+    // the same canonical form
+    std::unordered_map<uint64, unsigned int> last;
+    for (unsigned int i = 0; i < searches.size(); i++) {
+        const ComponentSearch& search = searches[i];
+        if (!search.canonical || search.stopped)
+            continue;
+        auto it = last.find(search.hash);
+        if (it != last.end() &&
+            searches[it->second].certificate == search.certificate) {
+            const ComponentSearch& previous = searches[it->second];
+            std::vector<unsigned int> position(search.labeling.size());
+            for (unsigned int j = 0; j < position.size(); j++)
+                position[search.labeling[j]] = j;
+
+            generators.emplace_back();
+            for (unsigned int j = 0; j < position.size(); j++)
+                generators.back().push_back({
+                    (*previous.nodes)[j],
+                    (*search.nodes)[position[previous.labeling[j]]]});
+            generatorFound();
+        }
+        last[search.hash] = i;
+    }
+
+    for (const std::vector<std::vector<unsigned int>>& cycles : generators) {
+        std::unique_ptr<Permutation> permutation(new Permutation(_num_vars));
+        for (const std::vector<unsigned int>& cycle : cycles) {
+            for (const unsigned int node : cycle) {
+                const LiteralIndex index = node2Literal(node, _num_vars);
+                if (index != kNoLiteralIndex)
+                    permutation->addToCurrentCycle(Literal(index));
+            }
+            permutation->closeCurrentCycle();
+        }
+        if (!permutation->isIdentity())
+            addGenerator(group, std::move(permutation));
+    }
+}
 
 }  // namespace cosy
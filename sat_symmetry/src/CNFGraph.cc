@@ -1,6 +1,8 @@
 // Copyright 2017 Hakan Metin
 #include "cosy/CNFGraph.h"
 
+#include <algorithm>
+
 
 namespace cosy {
 
@@ -16,22 +18,26 @@ CNFGraph::CNFGraph(const CNFModel& model) : CNFGraph() {
 CNFGraph::~CNFGraph() {
 }
 
-void CNFGraph::assign(const CNFModel& model) {
+// Calls add_edge(from, to) on each edge of the graph of the model, and
+// returns the number of nodes
+template <typename AddEdge>
+unsigned int CNFGraph::forEachEdge(const CNFModel& model,
+                                   AddEdge add_edge) const {
     unsigned int n = model.numberOfVariables();
     unsigned int num_clauses = 2 * n;
     unsigned int x, y, z;
     bool opt_optimized_graph = true;
 
     // Graph edges
-    for (const std::unique_ptr<Clause>& clause : model.clauses()) {
-        if (opt_optimized_graph && clause->size() == 2) {
-            x = literal2Node(clause->literals()[0], n);
-            y = literal2Node(clause->literals()[1], n);
-            addEdge(x, y);
+    for (const ClauseView clause : model.clauses()) {
+        if (opt_optimized_graph && clause.size() == 2) {
+            x = literal2Node(clause.literals()[0], n);
+            y = literal2Node(clause.literals()[1], n);
+            add_edge(x, y);
         } else {
-            for (const Literal& literal : *clause) {
+            for (const Literal& literal : clause) {
                 z = literal2Node(literal, n);
-                addEdge(z, num_clauses);
+                add_edge(z, num_clauses);
             }
             num_clauses++;
         }
@@ -40,9 +46,45 @@ void CNFGraph::assign(const CNFModel& model) {
     for (BooleanVariable var(0); var < n; ++var) {
         x = literal2Node(Literal(var, true), n);
         y = literal2Node(Literal(var, false), n);
-        addEdge(x, y);
+        add_edge(x, y);
     }
+    return num_clauses;
+}
+
+// Two passes on the edges: the first counts the degrees, the second fills
+// the rows, so that the adjacency is allocated once.
+void CNFGraph::assign(const CNFModel& model) {
+    unsigned int n = model.numberOfVariables();
+    unsigned int x, y;
+
+    std::vector<unsigned int> degrees;
+    _num_edges = 0;
+    degrees.reserve(2 * n);
+    _num_nodes = forEachEdge(model, [&](unsigned int from, unsigned int to) {
+        const unsigned int node = from > to ? from : to;
+        if (node >= degrees.size())
+            degrees.resize(node + 1, 0);
+        degrees[from]++;
+        degrees[to]++;
+        _num_edges++;
+    });
+    degrees.resize(_num_nodes, 0);
+
+    _offsets.assign(_num_nodes + 1, 0);
+    for (unsigned int node = 0; node < _num_nodes; ++node)
+        _offsets[node + 1] = _offsets[node] + degrees[node];
+    _targets.resize(_offsets[_num_nodes]);
+
+    // From here, degrees[node] is the next free position in the row of node
+    for (unsigned int node = 0; node < _num_nodes; ++node)
+        degrees[node] = _offsets[node];
+    forEachEdge(model, [&](unsigned int from, unsigned int to) {
+        _targets[degrees[from]++] = to;
+        _targets[degrees[to]++] = from;
+    });
+
     // Node color
+    _colors.assign(_num_nodes, 0);
     int color = kClauseColor + 1;
     for (BooleanVariable var(0); var < n; ++var) {
         x = literal2Node(Literal(var, true), n);
@@ -53,27 +95,38 @@ void CNFGraph::assign(const CNFModel& model) {
         }
     }
     // Clause color
-    for (unsigned int i=2*n; i < num_clauses; ++i)
+    for (unsigned int i=2*n; i < _num_nodes; ++i)
         changeColor(i, kClauseColor);
 }
 
-void CNFGraph::addNode(unsigned int node) {
-    if (_num_nodes > node)
-        return;
-    _num_nodes = node + 1;
-    _adjacency.resize(_num_nodes);
-    _colors.resize(_num_nodes);
-}
-
-void CNFGraph::addEdge(unsigned int from, unsigned int to) {
-    addNode(from > to ? from : to);
-    _adjacency[from].push_back(to);
-    _adjacency[to].push_back(from);
-    _num_edges++;
+int64 CNFGraph::memoryUsage() const {
+    return (_offsets.capacity() + _targets.capacity() + _colors.capacity()) *
+        sizeof(unsigned int);
 }
 
 void CNFGraph::changeColor(unsigned int node, unsigned int color) {
     _colors[node] = color;
 }
 
+std::vector<std::vector<unsigned int>> CNFGraph::components() const {
+    std::vector<std::vector<unsigned int>> components;
+    std::vector<bool> seen(_num_nodes, false);
+
+    for (unsigned int root = 0; root < _num_nodes; ++root) {
+        if (seen[root])
+            continue;
+        seen[root] = true;
+        components.emplace_back(1, root);
+        std::vector<unsigned int>& component = components.back();
+        for (unsigned int i = 0; i < component.size(); ++i)
+            for (const unsigned int x : neighbour(component[i]))
+                if (!seen[x]) {
+                    seen[x] = true;
+                    component.push_back(x);
+                }
+        std::sort(component.begin(), component.end());
+    }
+    return components;
+}
+
 }  // namespace cosy
@@ -1,10 +1,29 @@
 // Copyright 2017 Hakan Metin - LIP6
 
 #include "cosy/CNFModel.h"
+
+#include <algorithm>
+#include <cstdio>
+
 #include "cosy/Printer.h"
 
 namespace cosy {
 
+namespace {
+inline uint64 mix(uint64 h) {
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 29;
+    h *= 0x94D049BB133111EBULL;
+    return h ^ (h >> 32);
+}
+
+const int64 kMinTableSize = 1024;
+// Largest sizes reserved from the header, which may be wrong: past them the
+// arrays grow with the clauses read
+const int64 kMaxReserved = 1 << 20;
+}  // namespace
+
 CNFModel::CNFModel() :
     _num_variables(0),
     _num_clauses(0),
@@ -12,11 +31,31 @@ CNFModel::CNFModel() :
     _num_binary_clauses(0),
     _num_ternary_clauses(0),
     _num_large_clauses(0) {
+    _fingerprint[0] = _fingerprint[1] = 0;
+    _clause_starts.push_back(0);
 }
 
 CNFModel::~CNFModel() {
 }
 
+void CNFModel::reserve(int64 num_variables, int64 num_clauses) {
+    num_variables = std::min(num_variables, kMaxReserved);
+    num_clauses = std::min(num_clauses, kMaxReserved);
+    if (num_variables > static_cast<int64>(_occurences.size())) {
+        _positive_occurences.resize(num_variables);
+        _negative_occurences.resize(num_variables);
+        _occurences.resize(num_variables);
+    }
+    _clause_starts.reserve(num_clauses + 1);
+    _clause_hashes.reserve(num_clauses);
+
+    int64 table_size = kMinTableSize;
+    while (table_size < 2 * num_clauses)
+        table_size <<= 1;
+    if (table_size > static_cast<int64>(_clause_table.size()))
+        resize_table(table_size);
+}
+
 void CNFModel::addClause(std::vector<Literal>* literals) {
     CHECK_GT(literals->size(), static_cast<unsigned int>(0));
 
@@ -31,32 +70,112 @@ void CNFModel::addClause(std::vector<Literal>* literals) {
 
     _num_clauses++;
 
-    size_t tag = compute_tag(*literals);
-
     // If clause already exists do nothing
-    if (!(_clauses_tag.insert(tag)).second)
+    if (!insert_clause(*literals))
         return;
 
-    std::unique_ptr<Clause> clause(Clause::create(*literals));
-    _clauses.emplace_back(clause.release());
-
     compute_occurences(*literals);
     compute_sizes(*literals);
+    compute_fingerprint(*literals);
+}
+
+// Adds the clause to the arena unless it is already there
+bool CNFModel::insert_clause(const std::vector<Literal>& literals) {
+    const int64 index = _clause_hashes.size();
+    if (2 * (index + 1) > static_cast<int64>(_clause_table.size()))
+        resize_table(std::max<int64>(kMinTableSize, 2 * _clause_table.size()));
+
+    const uint64 hash = compute_hash(literals);
+    uint64 slot;
+    if (find_clause(literals, hash, &slot) >= 0)
+        return false;
+
+    _clause_table[slot] = index;
+    _clause_hashes.push_back(hash);
+    _literals.insert(_literals.end(), literals.begin(), literals.end());
+    _clause_starts.push_back(_literals.size());
+    return true;
+}
+
+bool CNFModel::hasClause(const std::vector<Literal>& literals) const {
+    uint64 slot;
+    return !_clause_table.empty() &&
+        find_clause(literals, compute_hash(literals), &slot) >= 0;
+}
+
+// Index of the clause, or -1 and the free slot of the table where it goes.
+// Clauses with the same hash are compared literal by literal.
+int64 CNFModel::find_clause(const std::vector<Literal>& literals, uint64 hash,
+                            uint64* slot) const {
+    const uint64 mask = _clause_table.size() - 1;
+    for (*slot = hash & mask; _clause_table[*slot] >= 0;
+         *slot = (*slot + 1) & mask) {
+        const int64 other = _clause_table[*slot];
+        if (_clause_hashes[other] != hash)
+            continue;
+        const int64 size = _clause_starts[other + 1] - _clause_starts[other];
+        const Literal* begin = _literals.data() + _clause_starts[other];
+        if (size == static_cast<int64>(literals.size()) &&
+            std::equal(literals.begin(), literals.end(), begin))
+            return other;
+    }
+    return -1;
 }
 
-size_t CNFModel::compute_tag(const std::vector<Literal>& literals) {
-    std::string word = "";
+// Rolling hash over the sorted literals
+uint64 CNFModel::compute_hash(const std::vector<Literal>& literals) const {
+    uint64 h = literals.size();
     for (const Literal& literal : literals)
-        word += std::to_string(literal.signedValue()) + " ";
-    return std::hash<std::string>()(word);
+        h = (h ^ literal.index().value()) * 0x100000001B3ULL;
+    return mix(h);
+}
+
+// The size of the table is a power of 2, at least twice the number of
+// clauses
+void CNFModel::resize_table(int64 size) {
+    const uint64 mask = size - 1;
+    _clause_table.assign(size, -1);
+    for (int64 index = 0; index < static_cast<int64>(_clause_hashes.size());
+         ++index) {
+        uint64 slot = _clause_hashes[index] & mask;
+        while (_clause_table[slot] >= 0)
+            slot = (slot + 1) & mask;
+        _clause_table[slot] = index;
+    }
+}
+
+// Each clause is hashed in two independent lanes over its sorted literals,
+// the clause hashes are summed: the sum is independent of the clause order.
+void CNFModel::compute_fingerprint(const std::vector<Literal>& literals) {
+    uint64 h0 = 0x9E3779B97F4A7C15ULL;
+    uint64 h1 = 0xC2B2AE3D27D4EB4FULL;
+    for (const Literal& literal : literals) {
+        const uint64 x = literal.index().value();
+        h0 = mix(h0 ^ x);
+        h1 = mix(h1 + x * 0x165667B19E3779F9ULL);
+    }
+    _fingerprint[0] += mix(h0 ^ literals.size());
+    _fingerprint[1] += mix(h1 + literals.size());
+}
+
+std::string CNFModel::fingerprint() const {
+    char digits[33];
+    snprintf(digits, sizeof(digits), "%016llx%016llx",
+             static_cast<unsigned long long>(  // NOLINT
+                 mix(_fingerprint[0] ^ numberOfVariables())),
+             static_cast<unsigned long long>(  // NOLINT
+                 mix(_fingerprint[1] + _clause_hashes.size())));
+    return std::string(digits);
 }
 
+// The occurrences are sized by reserve(), they only grow here when the
+// header of the problem is missing or wrong
 void CNFModel::compute_occurences(const std::vector<Literal>& literals) {
-    const int64 num_vars = numberOfVariables();
     for (const Literal& literal : literals) {
         const int64 index = literal.variable().value();
 
-        if (num_vars > index) {
+        if (index >= static_cast<int64>(_occurences.size())) {
+            const int64 num_vars = numberOfVariables();
             _positive_occurences.resize(num_vars);
             _negative_occurences.resize(num_vars);
             _occurences.resize(num_vars);
@@ -30,6 +30,7 @@ bool CNFReader::load(const std::string &filename, CNFModel *model) {
 
             expected_num_vars = in.readInt();
             expected_num_clauses = in.readInt();
+            model->reserve(expected_num_vars, expected_num_clauses);
             in.skipLine();
         } else {
             literals.clear();
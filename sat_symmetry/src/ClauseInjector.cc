@@ -4,6 +4,29 @@
 
 namespace cosy {
 
+void Injector::compact() {
+    std::vector<Literal> arena;
+
+    arena.reserve(std::max<size_t>(2 * _num_live_literals, 16));
+    for (unsigned int var = 0; var < _pending.size(); var++) {
+        if (!_pending[var])
+            continue;
+        Slot& slot = _slots[var];
+        arena.insert(arena.end(), _arena.begin() + slot.offset,
+                     _arena.begin() + slot.offset + slot.size);
+        slot.offset = arena.size() - slot.size;
+    }
+    for (Slot& slot : _unbound) {
+        arena.insert(arena.end(), _arena.begin() + slot.offset,
+                     _arena.begin() + slot.offset + slot.size);
+        slot.offset = arena.size() - slot.size;
+    }
+
+    DCHECK_EQ(arena.size(), _num_live_literals);
+    _arena.swap(arena);
+}
+
+
 ClauseInjector::ClauseInjector() {
     _injectors.resize(NR_TYPES);
 }
@@ -11,29 +34,44 @@ ClauseInjector::ClauseInjector() {
 ClauseInjector::~ClauseInjector() {
 }
 
+void ClauseInjector::resize(unsigned int num_vars) {
+    for (Injector& injector : _injectors)
+        injector.resize(num_vars);
+    _in_clause.ClearAndResize(LiteralIndex(num_vars << 1));
+}
+
 
 void ClauseInjector::addClause(Type type, BooleanVariable cause,
-                               std::vector<Literal>&& literals) {
-    _injectors[type].addClause(cause, std::move(literals));
+                               const std::vector<Literal>& literals) {
+    _injectors[type].addClause(cause, literals);
 }
 
 void ClauseInjector::removeClause(Type type, BooleanVariable cause) {
     _injectors[type].removeClause(cause);
 }
 
-bool ClauseInjector::hasClause(Type type, BooleanVariable cause) const {
-    return _injectors[type].hasClause(cause);
-}
-
 std::vector<Literal>
 ClauseInjector::getClause(Type type, BooleanVariable cause) {
+    const ClauseView clause = takeClause(type, cause);
+    return std::vector<Literal>(clause.begin(), clause.end());
+}
+
+ClauseView ClauseInjector::takeClause(Type type, BooleanVariable cause) {
     switch (type) {
     case UNITS:        _stats.units.increment();           break;
     case ESBP:         _stats.esbp.increment();            break;
     case ESBP_FORCING: _stats.esbp_forcing.increment();    break;
     default: CHECK_NOTNULL(nullptr);
     }
-    return _injectors[type].getClause(cause);
+    return _injectors[type].takeClause(cause);
+}
+
+void ClauseInjector::endClause(Type type, BooleanVariable cause) {
+    for (const Literal& literal : _clause)
+        _in_clause.Clear(literal.index());
+
+    _injectors[type].addClause(cause, _clause);
+    _clause.clear();
 }
 
 void ClauseInjector::removeClause(BooleanVariable cause) {
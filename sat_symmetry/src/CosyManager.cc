@@ -10,7 +10,8 @@ static const bool FLAGS_esbp_forcing = false;
 CosyManager::CosyManager(const Group& group, const Assignment& assignment) :
     _group(group),
     _assignment(assignment),
-    _order(nullptr) {
+    _order(nullptr),
+    _level(0) {
 }
 
 CosyManager::~CosyManager() {
@@ -49,7 +50,8 @@ void CosyManager::updateNotify(const Literal& literal,
     for (const unsigned int& index : _group.watch(variable)) {
         const std::unique_ptr<CosyStatus>& status = _statuses[index];
 
-        status->updateNotify(literal);
+        if (status->updateNotify(literal, _level))
+            _moved.push_back(index);
 
         if (FLAGS_esbp && status->state() == REDUCER) {
             status->generateESBP(literal.variable(), injector);
@@ -60,18 +62,21 @@ void CosyManager::updateNotify(const Literal& literal,
     }
 }
 
-void CosyManager::updateCancel(const Literal& literal) {
+void CosyManager::cancelUntil(int level) {
     IF_STATS_ENABLED({
             ScopedTimeDistributionUpdater time(&_stats.total_time);
             time.alsoUpdate(&_stats.cancel_time);
         });
 
-    const BooleanVariable variable = literal.variable();
-    for (const unsigned int& index : _group.watch(variable)) {
-        const std::unique_ptr<CosyStatus>& status = _statuses[index];
+    while (!_moved.empty()) {
+        const std::unique_ptr<CosyStatus>& status = _statuses[_moved.back()];
+        if (status->checkpointLevel() <= level)
+            break;
 
-        status->updateCancel(literal);
+        status->backtrack();
+        _moved.pop_back();
     }
+    _level = level < 0 ? 0 : level;
 }
 
 void CosyManager::summarize() const {
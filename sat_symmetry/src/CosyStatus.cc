@@ -39,10 +39,9 @@ void CosyStatus::generateUnitClauseOnInverting(ClauseInjector *injector) {
                         std::move(literals));
 }
 
-void CosyStatus::updateNotify(const Literal& literal) {
+bool CosyStatus::updateNotify(const Literal& /* literal */, int level) {
     unsigned int initial = _lookup_index;
     Literal element, inverse;
-    const BooleanVariable variable = literal.variable();
 
     for (; _lookup_index < _lookup_order.size(); ++_lookup_index) {
         element = _lookup_order[_lookup_index];
@@ -50,23 +49,17 @@ void CosyStatus::updateNotify(const Literal& literal) {
 
         if (!_assignment.hasSameAssignmentValue(element, inverse))
             break;
-
-        if (_lookup_index == initial)
-            _lookup_infos.push_back(LookupInfo(variable, _lookup_index));
     }
     updateState();
-}
-
-void CosyStatus::updateCancel(const Literal& literal) {
-    if (_lookup_infos.empty())
-        return;
 
-    const LookupInfo& lookup = _lookup_infos.back();
-    if (lookup.variable != literal.variable())
-        return;
+    if (_lookup_index == initial)
+        return false;
+    if (!_checkpoints.empty() && _checkpoints.back().level == level)
+        return false;
 
-    _lookup_index = lookup.back_index;
-    _lookup_infos.pop_back();
+    DCHECK(_checkpoints.empty() || _checkpoints.back().level < level);
+    _checkpoints.emplace_back(level, initial);
+    return true;
 }
 
 void CosyStatus::updateState() {
@@ -105,16 +98,13 @@ void CosyStatus::updateState() {
 
 void
 CosyStatus::generateESBP(BooleanVariable reason, ClauseInjector *injector) {
-    std::vector<Literal> literals;
-    std::unordered_set<Literal> used;
-    Literal element, inverse, l;
+    Literal element, inverse;
 
     DCHECK(!isLookupEnd());
     DCHECK_EQ(_state, REDUCER);
 
-    l = _assignment.getFalseLiteralForAssignedVariable(reason);
-    if (used.insert(l).second)
-        literals.push_back(l);
+    injector->beginClause();
+    injector->addLiteral(_assignment.getFalseLiteralForAssignedVariable(reason));
 
     for (unsigned int i = 0; i <= _lookup_index; i++) {
         element = _lookup_order[i];
@@ -122,27 +112,21 @@ CosyStatus::generateESBP(BooleanVariable reason, ClauseInjector *injector) {
 
         DCHECK(_assignment.bothLiteralsAreAssigned(element, inverse));
 
-        l = _assignment.getFalseLiteralForAssignedVariable(element.variable());
-        if (used.insert(l).second)
-            literals.push_back(l);
-
-        l = _assignment.getFalseLiteralForAssignedVariable(inverse.variable());
-        if (used.insert(l).second)
-            literals.push_back(l);
+        injector->addLiteral(
+            _assignment.getFalseLiteralForAssignedVariable(element.variable()));
+        injector->addLiteral(
+            _assignment.getFalseLiteralForAssignedVariable(inverse.variable()));
     }
 
-    DCHECK_GE(literals.size(), 2);
-    std::swap(literals[0], literals[1]);
+    DCHECK_GE(injector->clauseSize(), 2);
+    injector->swapLiterals(0, 1);
 
-    injector->addClause(ClauseInjector::Type::ESBP, reason,
-                        std::move(literals));
+    injector->endClause(ClauseInjector::Type::ESBP, reason);
 }
 
 void CosyStatus::generateForceLexLeaderESBP(BooleanVariable reason,
                                             ClauseInjector *injector) {
-    std::vector<Literal> literals;
-    std::unordered_set<Literal> used;
-    Literal element, inverse, l, affected, undef;
+    Literal element, inverse, affected, undef;
 
     DCHECK(!isLookupEnd());
 
@@ -152,17 +136,12 @@ void CosyStatus::generateForceLexLeaderESBP(BooleanVariable reason,
     undef = _assignment.literalIsAssigned(element) ? inverse : element;
     affected = _assignment.literalIsAssigned(inverse) ? inverse : element;
 
-    l = Literal(undef.variable(), _assignment.literalIsTrue(affected));
-    if (used.insert(l).second)
-        literals.push_back(l);
-
-    l = _assignment.getFalseLiteralForAssignedVariable(reason);
-    if (used.insert(l).second)
-        literals.push_back(l);
-
-    l = _assignment.getFalseLiteralForAssignedVariable(affected.variable());
-    if (used.insert(l).second)
-        literals.push_back(l);
+    injector->beginClause();
+    injector->addLiteral(Literal(undef.variable(),
+                                 _assignment.literalIsTrue(affected)));
+    injector->addLiteral(_assignment.getFalseLiteralForAssignedVariable(reason));
+    injector->addLiteral(
+        _assignment.getFalseLiteralForAssignedVariable(affected.variable()));
 
     for (unsigned int i = 0; i < _lookup_index; i++) {
         element = _lookup_order[i];
@@ -170,17 +149,13 @@ void CosyStatus::generateForceLexLeaderESBP(BooleanVariable reason,
 
         DCHECK(_assignment.bothLiteralsAreAssigned(element, inverse));
 
-        l = _assignment.getFalseLiteralForAssignedVariable(element.variable());
-        if (used.insert(l).second)
-            literals.push_back(l);
-
-        l = _assignment.getFalseLiteralForAssignedVariable(inverse.variable());
-        if (used.insert(l).second)
-            literals.push_back(l);
+        injector->addLiteral(
+            _assignment.getFalseLiteralForAssignedVariable(element.variable()));
+        injector->addLiteral(
+            _assignment.getFalseLiteralForAssignedVariable(inverse.variable()));
     }
 
-    injector->addClause(ClauseInjector::Type::ESBP_FORCING,
-                        reason, std::move(literals));
+    injector->endClause(ClauseInjector::Type::ESBP_FORCING, reason);
 }
 
 std::string CosyStatus::debugString() const {
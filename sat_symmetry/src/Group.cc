@@ -2,6 +2,7 @@
 
 #include "cosy/Group.h"
 #include "cosy/Printer.h"
+#include "cosy/SchreierSims.h"
 
 namespace cosy {
 
@@ -13,6 +14,7 @@ Group::~Group() {
 
 void Group::addPermutation(std::unique_ptr<Permutation>&& permutation) {
     CHECK_NOTNULL(permutation);
+    permutation->build();
 
     const unsigned int permutation_index = _permutations.size();
     const unsigned int num_cycles = permutation->numberOfCycles();
@@ -48,6 +50,14 @@ void Group::addPermutation(std::unique_ptr<Permutation>&& permutation) {
 }
 
 
+void Group::addAugmentedPermutation(
+    std::unique_ptr<Permutation>&& permutation) {
+    const int64 num_permutations = numberOfPermutations();
+    addPermutation(std::move(permutation));
+    if (numberOfPermutations() > num_permutations)
+        _num_augmented_generators++;
+}
+
 Group::Iterator Group::watch(BooleanVariable variable) const {
     const int index = variable.value();
     return Iterator(_watchers[index].begin(), _watchers[index].end());
@@ -84,6 +94,11 @@ void Group::summarize(unsigned int num_vars) const {
     Printer::printStat("Number of inverting", numberOfInverting());
 }
 
+double Group::log10Order(int64 max_words) const {
+    SchreierSims chain;
+    return chain.build(_permutations, max_words) ? chain.log10Order() : -1;
+}
+
 void Group::debugPrint() const {
     unsigned int i = 1;
     for (const std::unique_ptr<Permutation>& permutation : _permutations) {
@@ -0,0 +1,104 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include "cosy/GzipReader.h"
+
+namespace cosy {
+
+GzipReader::GzipReader(gzFile in) :
+    GzipReader(in, std::thread::hardware_concurrency() > 1) {
+}
+
+GzipReader::GzipReader(gzFile in, bool background) :
+    _in(in),
+    _buffers(new unsigned char[kNumBuffers * kBufferSize]),
+    _filled(0),
+    _released(0),
+    _holding(false),
+    _done(false),
+    _stop(false) {
+    // gzdirect reads the header: it is 1 for an uncompressed stream, where
+    // there is nothing to overlap but a copy.
+    if (background && gzdirect(_in) == 0)
+        _thread = std::thread(&GzipReader::inflate, this);
+}
+
+GzipReader::~GzipReader() {
+    if (!threaded())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _released_condition.notify_one();
+    _thread.join();
+}
+
+const unsigned char* GzipReader::next(unsigned int* size) {
+    *size = 0;
+    if (_done)
+        return nullptr;
+
+    if (!threaded()) {
+        const int bytes = gzread(_in, &_buffers[0], kBufferSize);
+        if (bytes <= 0) {
+            _done = true;
+            return nullptr;
+        }
+        *size = bytes;
+        return &_buffers[0];
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_holding) {
+        _released++;
+        _holding = false;
+        _released_condition.notify_one();
+    }
+    _filled_condition.wait(lock, [this] { return _filled > _released; });
+
+    const unsigned int slot = _released % kNumBuffers;
+    if (_sizes[slot] == 0) {
+        _done = true;
+        return nullptr;
+    }
+    _holding = true;
+    *size = _sizes[slot];
+    return &_buffers[slot * kBufferSize];
+}
+
+// Fills the free buffers in order, until the end of the stream or the
+// destruction of the reader.
+void GzipReader::inflate() {
+    for (;;) {
+        unsigned int slot;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _released_condition.wait(lock, [this] {
+                    return _stop || _filled - _released < kNumBuffers;
+                });
+            if (_stop)
+                return;
+            slot = _filled % kNumBuffers;
+        }
+
+        const int bytes = gzread(_in, &_buffers[slot * kBufferSize],
+                                 kBufferSize);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _sizes[slot] = bytes > 0 ? bytes : 0;
+            _filled++;
+        }
+        _filled_condition.notify_one();
+        if (bytes <= 0)
+            return;
+    }
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
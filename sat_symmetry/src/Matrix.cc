@@ -0,0 +1,72 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include "cosy/Matrix.h"
+
+namespace cosy {
+
+Matrix::Matrix(const std::vector<Literal>& first,
+               const std::vector<Literal>& second) {
+    CHECK_EQ(first.size(), second.size());
+    _matrix.push_back(first);
+    _matrix.push_back(second);
+    for (unsigned int c = 0; c < first.size(); ++c)
+        _columns.Add(c);
+}
+
+Matrix::~Matrix() {
+}
+
+void Matrix::addRow(const std::vector<Literal>& row) {
+    CHECK_EQ(row.size(), numberOfColumns());
+    _matrix.push_back(row);
+}
+
+void Matrix::joinColumns(unsigned int a, unsigned int b) {
+    _columns.Union(a, b);
+}
+
+void Matrix::augment(Group *group, unsigned int num_vars) {
+    for (unsigned int i = 0; i + 1 < numberOfRows(); ++i)
+        group->addAugmentedPermutation(swap(_matrix[i], _matrix[i + 1],
+                                            num_vars));
+
+    std::vector<int> last(numberOfColumns(), -1);
+    std::vector<Literal> a, b;
+    for (unsigned int c = 0; c < numberOfColumns(); ++c) {
+        const int set = _columns.Find(c);
+        if (last[set] >= 0) {
+            a.clear();
+            b.clear();
+            for (const std::vector<Literal>& row : _matrix) {
+                a.push_back(row[last[set]]);
+                b.push_back(row[c]);
+            }
+            group->addAugmentedPermutation(swap(a, b, num_vars));
+        }
+        last[set] = c;
+    }
+}
+
+std::unique_ptr<Permutation> Matrix::swap(const std::vector<Literal>& a,
+                                          const std::vector<Literal>& b,
+                                          unsigned int num_vars) const {
+    std::unique_ptr<Permutation> permutation(new Permutation(num_vars));
+    for (unsigned int i = 0; i < a.size(); ++i) {
+        permutation->addToCurrentCycle(a[i]);
+        permutation->addToCurrentCycle(b[i]);
+        permutation->closeCurrentCycle();
+        permutation->addToCurrentCycle(a[i].negated());
+        permutation->addToCurrentCycle(b[i].negated());
+        permutation->closeCurrentCycle();
+    }
+    return permutation;
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,248 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include "cosy/Matrixes.h"
+
+#include <algorithm>
+#include <string>
+
+#include "cosy/Printer.h"
+
+namespace cosy {
+
+Matrixes::Matrixes(const CNFModel& model) :
+    _model(model),
+    _num_vars(model.numberOfVariables()),
+    _stamp(0) {
+}
+
+Matrixes::~Matrixes() {
+}
+
+void Matrixes::detect(const Group& group) {
+    _matrix_of.assign(_num_vars, -1);
+    _column_of.assign(_num_vars, 0);
+
+    for (const std::unique_ptr<Permutation>& generator :
+             group.permutations()) {
+        if (!isSwap(*generator) || !startMatrix(*generator))
+            continue;
+        if (_occurence_starts.empty())
+            buildOccurences();
+
+        const unsigned int m = _matrixes.size() - 1;
+        addRows(group, m);
+        addColumns(group, m);
+    }
+}
+
+void Matrixes::augment(Group *group) {
+    for (const std::unique_ptr<Matrix>& matrix : _matrixes)
+        matrix->augment(group, _num_vars);
+}
+
+// Involution swapping positive literals only, on the variables of the model
+bool Matrixes::isSwap(const Permutation& permutation) const {
+    if (permutation.isIdentity())
+        return false;
+    for (unsigned int c = 0; c < permutation.numberOfCycles(); ++c) {
+        const Permutation::Iterator cycle = permutation.cycle(c);
+        if (cycle.size() != 2)
+            return false;
+        for (const Literal& literal : cycle)
+            if (literal.variable() >= _num_vars)
+                return false;
+        if (cycle.begin()->isPositive() != (cycle.begin() + 1)->isPositive())
+            return false;
+    }
+    return true;
+}
+
+// The two rows of a swap, the smallest variable of each cycle in the first
+// row
+bool Matrixes::startMatrix(const Permutation& permutation) {
+    std::vector<Literal> first, second;
+    for (unsigned int c = 0; c < permutation.numberOfCycles(); ++c) {
+        const Permutation::Iterator cycle = permutation.cycle(c);
+        const Literal a = *cycle.begin();
+        const Literal b = *(cycle.begin() + 1);
+        if (_matrix_of[a.variable().value()] >= 0 ||
+            _matrix_of[b.variable().value()] >= 0)
+            return false;
+        if (!a.isPositive())
+            continue;
+        first.push_back(a < b ? a : b);
+        second.push_back(a < b ? b : a);
+    }
+
+    const unsigned int m = _matrixes.size();
+    _matrixes.emplace_back(new Matrix(first, second));
+    for (unsigned int r = 0; r < 2; ++r)
+        for (unsigned int c = 0; c < first.size(); ++c) {
+            const int var = _matrixes[m]->row(r)[c].variable().value();
+            _matrix_of[var] = m;
+            _column_of[var] = c;
+        }
+    return true;
+}
+
+void Matrixes::addRow(unsigned int m, const std::vector<Literal>& row) {
+    _matrixes[m]->addRow(row);
+    for (unsigned int c = 0; c < row.size(); ++c) {
+        const int var = row[c].variable().value();
+        _matrix_of[var] = m;
+        _column_of[var] = c;
+    }
+}
+
+// Each row is mapped once by the generators moving its first literal, the
+// rows added are mapped in turn
+void Matrixes::addRows(const Group& group, unsigned int m) {
+    Matrix *matrix = _matrixes[m].get();
+    std::vector<Literal> image;
+
+    for (unsigned int r = 0; r < matrix->numberOfRows(); ++r) {
+        const BooleanVariable variable = matrix->row(r)[0].variable();
+        for (const int index : group.watch(variable)) {
+            const Permutation& generator = *group.permutations()[index];
+            const std::vector<Literal>& row = matrix->row(r);
+            bool fresh = true;
+            image.clear();
+            for (const Literal& literal : row) {
+                const Literal x = generator.imageOf(literal);
+                fresh = fresh && x.isPositive() &&
+                    x.variable() < _num_vars &&
+                    _matrix_of[x.variable().value()] < 0;
+                if (!fresh)
+                    break;
+                image.push_back(x);
+            }
+            if (fresh && isSymmetry(row, image))
+                addRow(m, image);
+        }
+    }
+}
+
+// A generator mapping the first literal of a column into another column of
+// the matrix gives a candidate swap of these columns, row by row, kept when
+// it is a symmetry of the clauses
+void Matrixes::addColumns(const Group& group, unsigned int m) {
+    Matrix *matrix = _matrixes[m].get();
+    std::vector<Literal> a, b;
+
+    for (unsigned int c = 0; c < matrix->numberOfColumns(); ++c) {
+        const BooleanVariable variable = matrix->row(0)[c].variable();
+        for (const int index : group.watch(variable)) {
+            const Permutation& generator = *group.permutations()[index];
+            const Literal x = generator.imageOf(matrix->row(0)[c]);
+            const int var = x.variable().value();
+            if (!x.isPositive() || _matrix_of[var] != static_cast<int>(m))
+                continue;
+            const unsigned int d = _column_of[var];
+            if (d == c)
+                continue;
+
+            a.clear();
+            b.clear();
+            for (unsigned int r = 0; r < matrix->numberOfRows(); ++r) {
+                a.push_back(matrix->row(r)[c]);
+                b.push_back(matrix->row(r)[d]);
+            }
+            if (isSymmetry(a, b))
+                matrix->joinColumns(c, d);
+        }
+    }
+}
+
+// Swapping the literals of a and b one by one (and their negations) is a
+// symmetry if it maps each clause on one of them to a clause of the model
+bool Matrixes::isSymmetry(const std::vector<Literal>& a,
+                          const std::vector<Literal>& b) {
+    for (unsigned int i = 0; i < a.size(); ++i) {
+        _image[a[i].index().value()] = b[i];
+        _image[b[i].index().value()] = a[i];
+        _image[a[i].negated().index().value()] = b[i].negated();
+        _image[b[i].negated().index().value()] = a[i].negated();
+    }
+
+    _stamp++;
+    bool symmetry = true;
+    for (unsigned int i = 0; symmetry && i < 2 * a.size(); ++i) {
+        const Literal x = i < a.size() ? a[i] : b[i - a.size()];
+        for (const Literal literal : { x, x.negated() }) {
+            const int64 index = literal.index().value();
+            for (int64 j = _occurence_starts[index];
+                 symmetry && j < _occurence_starts[index + 1]; ++j) {
+                const int64 k = _occurence_clauses[j];
+                if (_checked[k] == _stamp)
+                    continue;
+                _checked[k] = _stamp;
+
+                _mapped.clear();
+                for (const Literal& y : _model.clause(k))
+                    _mapped.push_back(_image[y.index().value()]);
+                std::sort(_mapped.begin(), _mapped.end());
+                symmetry = _model.hasClause(_mapped);
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < a.size(); ++i)
+        for (const Literal x : { a[i], b[i] }) {
+            _image[x.index().value()] = x;
+            _image[x.negated().index().value()] = x.negated();
+        }
+    return symmetry;
+}
+
+void Matrixes::buildOccurences() {
+    const int64 num_literals = 2 * static_cast<int64>(_num_vars);
+    _occurence_starts.assign(num_literals + 1, 0);
+    for (const ClauseView clause : _model.clauses())
+        for (const Literal& literal : clause)
+            _occurence_starts[literal.index().value() + 1]++;
+    for (int64 i = 0; i < num_literals; ++i)
+        _occurence_starts[i + 1] += _occurence_starts[i];
+
+    std::vector<int64> next(_occurence_starts.begin(),
+                            _occurence_starts.end() - 1);
+    _occurence_clauses.resize(_occurence_starts[num_literals]);
+    int64 k = 0;
+    for (const ClauseView clause : _model.clauses()) {
+        for (const Literal& literal : clause)
+            _occurence_clauses[next[literal.index().value()]++] = k;
+        k++;
+    }
+
+    _image.clear();
+    for (int64 i = 0; i < num_literals; ++i)
+        _image.push_back(Literal(LiteralIndex(i)));
+    _checked.assign(k, 0);
+}
+
+void Matrixes::summarize() const {
+    int64 rows = 0;
+    std::string largest = "-";
+    unsigned int largest_size = 0;
+    for (const std::unique_ptr<Matrix>& matrix : _matrixes) {
+        const unsigned int size =
+            matrix->numberOfRows() * matrix->numberOfColumns();
+        rows += matrix->numberOfRows();
+        if (size > largest_size) {
+            largest_size = size;
+            largest = std::to_string(matrix->numberOfRows()) + "x" +
+                std::to_string(matrix->numberOfColumns());
+        }
+    }
+    Printer::printStat("Number of matrices", size());
+    Printer::printStat(" |- rows in matrices", rows);
+    Printer::printStat(" |- largest matrix", largest);
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -5,17 +5,7 @@
 namespace cosy {
 
 void Permutation::addToCurrentCycle(Literal x) {
-    const int cs = _cycles.size();
-    const int back = _cycles_lim.empty() ? 0 : _cycles_lim.back();
     _cycles.push_back(x);
-
-    // Add image and inverse to access in lookup unordered_map
-    if (_cycles.size() > 0 && cs != back) {
-        const Literal e = _cycles[cs - 1];
-        const Literal i = _cycles[cs];
-        _image[e] = i;
-        _inverse[i] = e;
-    }
 }
 
 void Permutation::closeCurrentCycle() {
@@ -28,12 +18,12 @@ void Permutation::closeCurrentCycle() {
     DCHECK_GE(sz - last, 2);
     _cycles_lim.push_back(sz);
 
-    // Add image and inverse to access in lookup unordered_map
-    const int num_cycle = _cycles_lim.size() - 1;
-    const Literal e = lastElementInCycle(num_cycle);
-    const Literal i = *(cycle(num_cycle).begin());
-    _image[e] = i;
-    _inverse[i] = e;
+    for (int i = last; i < sz; ++i)
+        _lookup->add(_cycles[i], _cycles[i + 1 < sz ? i + 1 : last]);
+}
+
+void Permutation::build() {
+    _lookup->build();
 }
 
 Permutation::Iterator Permutation::cycle(unsigned int i) const {
@@ -51,22 +41,6 @@ Literal Permutation::lastElementInCycle(unsigned int i) const {
     return _cycles[_cycles_lim[i] - 1];
 }
 
-const Literal Permutation::imageOf(const Literal& element) const {
-    return _image.at(element);
-}
-const Literal Permutation::inverseOf(const Literal& element) const {
-    return _inverse.at(element);
-}
-
-bool Permutation::isTrivialImage(const Literal& element) const {
-    return _image.find(element) == _image.end();
-}
-bool Permutation::isTrivialInverse(const Literal& element) const {
-    return _inverse.find(element) == _inverse.end();
-}
-
-
-
 static int gcd(int a, int b) {
     for (;;) {
         if (a == 0)
@@ -125,6 +99,7 @@ std::unique_ptr<Permutation> Permutation::mult(int order) const {
         }
         perm->closeCurrentCycle();
     }
+    perm->build();
 
     return std::move(perm);
 }
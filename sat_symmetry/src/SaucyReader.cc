@@ -2,6 +2,9 @@
 
 #include "cosy/SaucyReader.h"
 
+#include <climits>
+#include <utility>
+
 namespace {
 static inline int graphNodeToInt(int node, int num_vars) {
     if (node <= num_vars)
@@ -12,63 +15,102 @@ static inline int graphNodeToInt(int node, int num_vars) {
         return 0;  // represent clause
 }
 
+// Reads the next character, which must be c
+static inline bool expect(cosy::StreamBuffer* in, int c) {
+    if (**in != c)
+        return false;
+    ++(*in);
+    return true;
+}
+
+// Reads a positive node number without overflow
+static inline bool readNode(cosy::StreamBuffer* in, int* node) {
+    if (**in < '1' || **in > '9')
+        return false;
+    *node = 0;
+    while (**in >= '0' && **in <= '9') {
+        if (*node > (INT_MAX - 9) / 10)
+            return false;
+        *node = *node * 10 + (**in - '0');
+        ++(*in);
+    }
+    return true;
+}
+
 }  // namespace
 
 namespace cosy {
 
-bool SaucyReader::load(const std::string& symmetry_filename,
-                       unsigned int num_vars, Group *group) {
-    std::unique_ptr<Permutation> generator;
+// Each generator is a line of cycles "(a,b,...)", the generators are
+// separated by ",\n" and enclosed by "[\n" and "]". A cycle is either of
+// literal nodes or of clause nodes, which are dropped.
+bool SaucyReader::read(const std::string& symmetry_filename,
+                       unsigned int num_vars,
+                       std::vector<std::unique_ptr<Permutation>>* generators) {
     StreamBuffer in(symmetry_filename);
+    std::vector<bool> moved(2 * num_vars, false);
+    std::unique_ptr<Permutation> generator;
     int parsed, cnf_int;
-    Literal lit;
-
-    CHECK_EQ(*in, '[');
-    ++in;
-    CHECK_EQ(*in, '\n');
-    ++in;
 
-    if (*in == ']')  // No generator exists
+    generators->clear();
+    if (!expect(&in, '[') || !expect(&in, '\n'))
+        return false;
+    if (expect(&in, ']'))  // No generator exists
         return true;
 
-    while (*in != '\n') {
-        CHECK_EQ(*in, '(');
+    bool valid = true;
+    while (valid && *in == '(') {
         generator = std::unique_ptr<Permutation>(new Permutation(num_vars));
 
-        while (*in == '(') {
-            ++in;
-            parsed = in.readInt();
-            cnf_int = graphNodeToInt(parsed, num_vars);
-            if (cnf_int != 0) {
-                lit = Literal(cnf_int);
-                generator->addToCurrentCycle(lit);
-            }
-
-            while (*in != ')') {
-                CHECK_EQ(*in, ',');
-                ++in;
-                parsed = in.readInt();
+        while (valid && expect(&in, '(')) {
+            int literals = 0, clauses = 0;
+            do {
+                valid = readNode(&in, &parsed);
+                if (!valid)
+                    break;
                 cnf_int = graphNodeToInt(parsed, num_vars);
-                if (cnf_int != 0) {
-                    lit = Literal(cnf_int);
-                    generator->addToCurrentCycle(lit);
+                if (cnf_int == 0) {
+                    clauses++;
+                    continue;
                 }
-            }
-            CHECK_EQ(*in, ')');
-            generator->closeCurrentCycle();
-            ++in;
-        }
-        group->addPermutation(std::move(generator));
-        /* End of Generator line */
-        if (*in == ',') {
-            ++in;
-            CHECK_EQ(*in, '\n');
-            ++in;
+                const Literal lit(cnf_int);
+                valid = !moved[lit.index().value()];
+                moved[lit.index().value()] = true;
+                generator->addToCurrentCycle(lit);
+                literals++;
+            } while (valid && expect(&in, ','));
+
+            valid = valid && expect(&in, ')') &&
+                (clauses == 0 ? literals >= 2 : literals == 0);
+            if (valid)
+                generator->closeCurrentCycle();
         }
+        for (const Literal& lit : generator->support())
+            moved[lit.index().value()] = false;
+        if (!valid)
+            break;
+
+        // The cycles are those of a permutation: build() cannot fail
+        generator->build();
+        generators->push_back(std::move(generator));
+        if (!expect(&in, ','))
+            break;
+        valid = expect(&in, '\n');
     }
-    ++in;
-    CHECK_EQ(*in, ']');
 
+    valid = valid && expect(&in, '\n') && expect(&in, ']');
+    if (!valid)
+        generators->clear();
+    return valid;
+}
+
+bool SaucyReader::load(const std::string& symmetry_filename,
+                       unsigned int num_vars, Group *group) {
+    std::vector<std::unique_ptr<Permutation>> generators;
+    if (!read(symmetry_filename, num_vars, &generators))
+        return false;
+    for (std::unique_ptr<Permutation>& generator : generators)
+        group->addPermutation(std::move(generator));
     return true;
 }
 
@@ -0,0 +1,586 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include "cosy/SaucySymmetryFinder.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "cosy/DisjointSets.h"
+
+namespace cosy {
+
+namespace {
+
+// A split of a cell, in the order they are made. The new cell starts at
+// position 'fragment' and comes from the cell starting at 'parent'; its
+// nodes have 'count' neighbours in the splitter (-1 for an individualized
+// node). Two colorings refined in parallel stay isomorphic as long as they
+// make the same splits.
+struct Split {
+    unsigned int fragment;
+    unsigned int parent;
+    int count;
+
+    bool operator==(const Split& other) const {
+        return fragment == other.fragment && parent == other.parent &&
+            count == other.count;
+    }
+};
+
+// Ordered partition of the nodes, in cells of consecutive positions of
+// _lab, refined to an equitable partition. The refinement only depends on
+// the positions of the cells and on the graph, not on the order of the nodes
+// inside a cell: isomorphic colorings are refined into isomorphic colorings.
+class Coloring {
+ public:
+    Coloring(const CNFGraph& graph, const std::vector<unsigned int>& colors);
+
+    unsigned int node(unsigned int position) const { return _lab[position]; }
+    unsigned int cellOf(unsigned int node) const { return _cfront[node]; }
+    unsigned int cellSize(unsigned int start) const { return _clen[start] + 1; }
+    bool isSingleton(unsigned int node) const {
+        return _clen[_cfront[node]] == 0;
+    }
+
+    void individualize(unsigned int node);
+    // Stops early, leaving the coloring not equitable, if the time budget
+    // of finder (if any) is exhausted
+    bool refine(SymmetryFinder* finder = nullptr);
+
+    const std::vector<Split>& splits() const { return _splits; }
+    void undo(size_t num_splits);
+
+ private:
+    const CNFGraph* _graph;
+    std::vector<unsigned int> _lab;
+    std::vector<unsigned int> _unlab;
+    std::vector<unsigned int> _cfront;   // Start of the cell of a node
+    std::vector<unsigned int> _clen;     // Size - 1 of a cell, by start
+    std::vector<unsigned int> _count;    // Neighbours in the splitter
+    std::vector<unsigned int> _touched;  // Touched nodes of a cell, by start
+    std::vector<unsigned int> _touched_nodes;
+    std::vector<unsigned int> _touched_cells;
+    std::vector<unsigned int> _splitter;
+    std::vector<unsigned int> _queue;
+    std::vector<bool> _in_queue;
+    std::vector<Split> _splits;
+
+    void touch(unsigned int node);
+    void splitCell(unsigned int start);
+    void addSplit(unsigned int fragment, unsigned int parent, int count,
+                  unsigned int end);
+    void enqueue(unsigned int start);
+    void swap(unsigned int p, unsigned int q);
+};
+
+Coloring::Coloring(const CNFGraph& graph,
+                   const std::vector<unsigned int>& colors) :
+    _graph(&graph) {
+    const unsigned int n = graph.numberOfNodes();
+    _lab.resize(n);
+    _unlab.resize(n);
+    _cfront.resize(n);
+    _clen.assign(n, 0);
+    _count.assign(n, 0);
+    _touched.assign(n, 0);
+    _in_queue.assign(n, false);
+
+    // One cell by color, in increasing colors
+    for (unsigned int node = 0; node < n; ++node)
+        _lab[node] = node;
+    std::stable_sort(_lab.begin(), _lab.end(),
+                     [&colors](unsigned int a, unsigned int b) {
+                         return colors[a] < colors[b];
+                     });
+    unsigned int start = 0;
+    for (unsigned int p = 0; p < n; ++p) {
+        _unlab[_lab[p]] = p;
+        if (p > 0 && colors[_lab[p]] != colors[_lab[p - 1]]) {
+            enqueue(start);
+            start = p;
+        }
+        _cfront[_lab[p]] = start;
+        _clen[start] = p - start;
+    }
+    if (n > 0)
+        enqueue(start);
+}
+
+void Coloring::swap(unsigned int p, unsigned int q) {
+    const unsigned int a = _lab[p], b = _lab[q];
+    _lab[p] = b;
+    _lab[q] = a;
+    _unlab[b] = p;
+    _unlab[a] = q;
+}
+
+void Coloring::enqueue(unsigned int start) {
+    if (_in_queue[start])
+        return;
+    _in_queue[start] = true;
+    _queue.push_back(start);
+}
+
+void Coloring::individualize(unsigned int node) {
+    const unsigned int start = _cfront[node];
+    if (_clen[start] == 0)
+        return;
+
+    // The node is moved to the last position of its cell, which it leaves
+    const unsigned int last = start + _clen[start];
+    swap(_unlab[node], last);
+    _cfront[node] = last;
+    _clen[last] = 0;
+    _clen[start]--;
+    _splits.push_back({last, start, -1});
+    enqueue(last);
+}
+
+// Touched nodes are gathered at the end of their cell
+void Coloring::touch(unsigned int node) {
+    const unsigned int start = _cfront[node];
+    if (_count[node]++ != 0)
+        return;
+    _touched_nodes.push_back(node);
+    if (_touched[start] == 0)
+        _touched_cells.push_back(start);
+    const unsigned int last = start + _clen[start] - _touched[start];
+    swap(_unlab[node], last);
+    _touched[start]++;
+}
+
+bool Coloring::refine(SymmetryFinder* finder) {
+    for (unsigned int head = 0; head < _queue.size(); ++head) {
+        if (finder != nullptr && (head & 1023) == 1023 &&
+            finder->timeExhausted()) {
+            for (; head < _queue.size(); ++head)
+                _in_queue[_queue[head]] = false;
+            _queue.clear();
+            return false;
+        }
+        const unsigned int splitter = _queue[head];
+        _in_queue[splitter] = false;
+
+        // The splitter itself can be touched, its nodes are copied first
+        _splitter.assign(_lab.begin() + splitter,
+                         _lab.begin() + splitter + _clen[splitter] + 1);
+        for (const unsigned int node : _splitter)
+            for (const unsigned int x : _graph->neighbour(node))
+                touch(x);
+
+        std::sort(_touched_cells.begin(), _touched_cells.end());
+        for (const unsigned int start : _touched_cells) {
+            splitCell(start);
+            _touched[start] = 0;
+        }
+        for (const unsigned int node : _touched_nodes)
+            _count[node] = 0;
+        _touched_nodes.clear();
+        _touched_cells.clear();
+    }
+    _queue.clear();
+    return true;
+}
+
+// Splits a touched cell by number of neighbours in the splitter, untouched
+// nodes first then by increasing counts
+void Coloring::splitCell(unsigned int start) {
+    const unsigned int size = _clen[start] + 1;
+    const unsigned int end = start + size;
+    const unsigned int first_touched = end - _touched[start];
+    if (size == 1)
+        return;
+
+    std::sort(_lab.begin() + first_touched, _lab.begin() + end,
+              [this](unsigned int a, unsigned int b) {
+                  return _count[a] < _count[b];
+              });
+    for (unsigned int p = first_touched; p < end; ++p)
+        _unlab[_lab[p]] = p;
+
+    if (first_touched == start &&
+        _count[_lab[start]] == _count[_lab[end - 1]])
+        return;
+
+    // Fragment boundaries
+    std::vector<unsigned int> fragments;
+    if (first_touched > start)
+        fragments.push_back(first_touched);
+    for (unsigned int p = first_touched + 1; p < end; ++p)
+        if (_count[_lab[p]] != _count[_lab[p - 1]])
+            fragments.push_back(p);
+
+    // Hopcroft: a cell already waiting is refined by all its fragments,
+    // otherwise the largest fragment is left out
+    const bool waiting = _in_queue[start];
+    unsigned int largest = start;
+    unsigned int largest_size = fragments[0] - start;
+    for (unsigned int f = 0; f < fragments.size(); ++f) {
+        const unsigned int f_end = f + 1 < fragments.size() ?
+            fragments[f + 1] : end;
+        if (f_end - fragments[f] > largest_size) {
+            largest = fragments[f];
+            largest_size = f_end - fragments[f];
+        }
+    }
+
+    // Each fragment is split from the previous one, so that the splits
+    // are undone by merging adjacent cells
+    unsigned int parent = start;
+    for (unsigned int f = 0; f < fragments.size(); ++f) {
+        const unsigned int f_end = f + 1 < fragments.size() ?
+            fragments[f + 1] : end;
+        addSplit(fragments[f], parent, _count[_lab[fragments[f]]], f_end);
+        parent = fragments[f];
+    }
+    if (!waiting && largest != start)
+        enqueue(start);
+    for (const unsigned int fragment : fragments)
+        if (waiting || fragment != largest)
+            enqueue(fragment);
+}
+
+void Coloring::addSplit(unsigned int fragment, unsigned int parent,
+                        int count, unsigned int end) {
+    for (unsigned int p = fragment; p < end; ++p)
+        _cfront[_lab[p]] = fragment;
+    _clen[fragment] = end - fragment - 1;
+    _clen[parent] = fragment - parent - 1;
+    _splits.push_back({fragment, parent, count});
+}
+
+void Coloring::undo(size_t num_splits) {
+    while (_splits.size() > num_splits) {
+        const Split split = _splits.back();
+        _splits.pop_back();
+
+        const unsigned int end = split.fragment + _clen[split.fragment] + 1;
+        for (unsigned int p = split.fragment; p < end; ++p)
+            _cfront[_lab[p]] = split.parent;
+        _clen[split.parent] = end - split.parent - 1;
+    }
+}
+
+
+// Search tree of the partitions refined by individualization, as in
+// Saucy. The first path individualizes the first node of the first
+// non-singleton cell down to a discrete partition. Then, from the bottom
+// up, for each level and each node of its target cell not yet in the
+// orbit of the first path node, a coloring refined in parallel ("right")
+// looks for an automorphism mapping the first path node to that node. The
+// automorphisms found generate the automorphism group of the graph, or a
+// subgroup of it if the budget of the finder stops the search.
+class SaucySearch {
+ public:
+    SaucySearch(const CNFGraph& graph, unsigned int num_vars, Group* group,
+                SymmetryFinder* finder);
+
+    void run();
+
+ private:
+    const CNFGraph& _graph;
+    const unsigned int _num_vars;
+    Group* _group;
+    SymmetryFinder* _finder;
+
+    Coloring _left;
+    Coloring _right;
+
+    // First path: target cell, individualized node and number of splits of
+    // the colorings when reaching each level
+    std::vector<unsigned int> _targets;
+    std::vector<unsigned int> _path;
+    std::vector<size_t> _left_marks;
+    std::vector<size_t> _right_marks;
+
+    DisjointSets _orbits;
+    std::vector<unsigned int> _gamma;
+    std::vector<unsigned int> _support;
+    std::vector<int> _edge_count;
+    std::vector<bool> _seen;
+
+    struct Frame {
+        unsigned int level;
+        std::vector<unsigned int> candidates;
+        unsigned int next;
+        size_t left_mark;
+        size_t left_end;
+        size_t right_mark;
+    };
+
+    static std::vector<unsigned int> colorsOf(const CNFGraph& graph);
+    std::vector<unsigned int> cellNodes(const Coloring& coloring,
+                                        unsigned int start) const;
+    bool sameSplits(size_t left_begin, size_t left_end,
+                    size_t right_begin) const;
+    bool sameOrbit(unsigned int a, unsigned int b);
+    bool searchBranch(unsigned int level, unsigned int node,
+                      size_t left_mark, size_t left_end);
+    bool tryAutomorphism(size_t right_mark);
+    bool isAutomorphism();
+    void addAutomorphism();
+};
+
+std::vector<unsigned int> SaucySearch::colorsOf(const CNFGraph& graph) {
+    std::vector<unsigned int> colors(graph.numberOfNodes());
+    for (unsigned int node = 0; node < colors.size(); ++node)
+        colors[node] = graph.color(node);
+    return colors;
+}
+
+SaucySearch::SaucySearch(const CNFGraph& graph, unsigned int num_vars,
+                         Group* group, SymmetryFinder* finder) :
+    _graph(graph),
+    _num_vars(num_vars),
+    _group(group),
+    _finder(finder),
+    _left(_graph, colorsOf(graph)),
+    _right(_left) {
+    const unsigned int n = _graph.numberOfNodes();
+    _gamma.resize(n);
+    for (unsigned int node = 0; node < n; ++node)
+        _gamma[node] = node;
+    _edge_count.assign(n, 0);
+    _seen.assign(n, false);
+}
+
+std::vector<unsigned int>
+SaucySearch::cellNodes(const Coloring& coloring, unsigned int start) const {
+    std::vector<unsigned int> nodes;
+    for (unsigned int p = start; p < start + coloring.cellSize(start); ++p)
+        nodes.push_back(coloring.node(p));
+    std::sort(nodes.begin(), nodes.end());
+    return nodes;
+}
+
+bool SaucySearch::sameSplits(size_t left_begin, size_t left_end,
+                             size_t right_begin) const {
+    const std::vector<Split>& left = _left.splits();
+    const std::vector<Split>& right = _right.splits();
+    if (right.size() - right_begin != left_end - left_begin)
+        return false;
+    return std::equal(left.begin() + left_begin, left.begin() + left_end,
+                      right.begin() + right_begin);
+}
+
+bool SaucySearch::sameOrbit(unsigned int a, unsigned int b) {
+    if (a == b)
+        return true;
+    _orbits.Add(a);
+    _orbits.Add(b);
+    return _orbits.Find(a) == _orbits.Find(b);
+}
+
+void SaucySearch::run() {
+    const unsigned int n = _graph.numberOfNodes();
+    // Both colorings start from the same equitable partition
+    if (!_left.refine(_finder))
+        return;
+    _right = _left;
+
+    // First path
+    unsigned int cursor = 0;
+    while (cursor < n) {
+        const unsigned int start = _left.cellOf(_left.node(cursor));
+        if (_left.cellSize(start) == 1) {
+            cursor = start + 1;
+            continue;
+        }
+        if (_finder->budgetExhausted())
+            return;
+        const unsigned int node = _left.node(start);
+        _targets.push_back(start);
+        _path.push_back(node);
+        _left_marks.push_back(_left.splits().size());
+        _right_marks.push_back(_right.splits().size());
+        _left.individualize(node);
+        _left.refine();
+        _right.individualize(node);
+        _right.refine();
+        cursor = start;
+    }
+
+    // From the bottom up
+    for (int level = static_cast<int>(_path.size()) - 1; level >= 0; --level) {
+        _left.undo(_left_marks[level]);
+        _right.undo(_right_marks[level]);
+
+        const unsigned int first = _path[level];
+        const std::vector<unsigned int> candidates =
+            cellNodes(_right, _targets[level]);
+        const size_t left_mark = _left.splits().size();
+        _left.individualize(first);
+        _left.refine();
+        const size_t left_end = _left.splits().size();
+
+        std::vector<unsigned int> failed;
+        for (const unsigned int node : candidates) {
+            if (sameOrbit(node, first))
+                continue;
+            bool known_failure = false;
+            for (const unsigned int f : failed)
+                known_failure = known_failure || sameOrbit(node, f);
+            if (known_failure)
+                continue;
+            if (!searchBranch(level, node, left_mark, left_end))
+                failed.push_back(node);
+            if (!_finder->complete())
+                return;
+        }
+    }
+}
+
+// Looks for an automorphism mapping the first path node of the level to
+// node. The left coloring is at the next level of the first path.
+bool SaucySearch::searchBranch(unsigned int level, unsigned int node,
+                               size_t left_mark, size_t left_end) {
+    const size_t branch_mark = _right.splits().size();
+    std::vector<Frame> frames;
+    frames.push_back({level, {node}, 0, left_mark, left_end, branch_mark});
+
+    bool found = false;
+    while (!frames.empty() && !found) {
+        Frame& frame = frames.back();
+        _right.undo(frame.right_mark);
+        if (frame.next == frame.candidates.size()) {
+            if (frames.size() > 1)
+                _left.undo(frame.left_mark);
+            frames.pop_back();
+            continue;
+        }
+        if (_finder->budgetExhausted())
+            break;
+
+        _right.individualize(frame.candidates[frame.next++]);
+        _right.refine();
+        if (!sameSplits(frame.left_mark, frame.left_end, frame.right_mark))
+            continue;
+        if (tryAutomorphism(branch_mark)) {
+            found = true;
+            break;
+        }
+
+        // Both colorings go one level down the first path
+        const unsigned int next_level = frame.level + 1;
+        if (next_level == _path.size())
+            continue;
+        const size_t next_left_mark = _left.splits().size();
+        _left.individualize(_path[next_level]);
+        _left.refine();
+        frames.push_back({next_level,
+                          cellNodes(_right, _targets[next_level]), 0,
+                          next_left_mark, _left.splits().size(),
+                          _right.splits().size()});
+    }
+
+    while (!frames.empty()) {
+        if (frames.size() > 1)
+            _left.undo(frames.back().left_mark);
+        frames.pop_back();
+    }
+    _right.undo(branch_mark);
+    return found;
+}
+
+// Candidate mapping the singleton cells of the left coloring to the
+// singleton cells at the same positions of the right coloring, the other
+// nodes to themselves. Only the cells split since the branch can differ.
+bool SaucySearch::tryAutomorphism(size_t right_mark) {
+    const std::vector<Split>& splits = _right.splits();
+    bool valid = true;
+    for (size_t s = right_mark; s < splits.size() && valid; ++s) {
+        for (const unsigned int start : {splits[s].fragment,
+                                         splits[s].parent}) {
+            if (_right.cellSize(start) != 1)
+                continue;
+            const unsigned int from = _left.node(start);
+            const unsigned int to = _right.node(start);
+            if (from == to || _gamma[from] != from)
+                continue;
+            if (!_left.isSingleton(to)) {
+                valid = false;
+                break;
+            }
+            _gamma[from] = to;
+            _support.push_back(from);
+        }
+    }
+
+    valid = valid && !_support.empty() && isAutomorphism();
+    if (valid)
+        addAutomorphism();
+    for (const unsigned int node : _support)
+        _gamma[node] = node;
+    _support.clear();
+    return valid;
+}
+
+// Neighbourhoods are only compared on the support, the edges between
+// fixed nodes are kept
+bool SaucySearch::isAutomorphism() {
+    for (const unsigned int node : _support) {
+        const unsigned int image = _gamma[node];
+        if (_graph.degree(node) != _graph.degree(image))
+            return false;
+        const Neighbours from = _graph.neighbour(node);
+        const Neighbours to = _graph.neighbour(image);
+        for (const unsigned int x : from)
+            _edge_count[_gamma[x]]++;
+        bool valid = true;
+        for (const unsigned int y : to)
+            valid = _edge_count[y]-- > 0 && valid;
+        for (const unsigned int x : from)
+            _edge_count[_gamma[x]] = 0;
+        for (const unsigned int y : to)
+            _edge_count[y] = 0;
+        if (!valid)
+            return false;
+    }
+    return true;
+}
+
+void SaucySearch::addAutomorphism() {
+    std::unique_ptr<Permutation> permutation(new Permutation(_num_vars));
+    for (const unsigned int node : _support) {
+        _orbits.Add(node);
+        _orbits.Add(_gamma[node]);
+        _orbits.Union(node, _gamma[node]);
+
+        if (_seen[node])
+            continue;
+        for (unsigned int x = node; !_seen[x]; x = _gamma[x]) {
+            _seen[x] = true;
+            const LiteralIndex index = node2Literal(x, _num_vars);
+            if (index != kNoLiteralIndex)
+                permutation->addToCurrentCycle(Literal(index));
+        }
+        permutation->closeCurrentCycle();
+    }
+    for (const unsigned int node : _support)
+        _seen[node] = false;
+    _finder->addGenerator(_group, std::move(permutation));
+    _finder->generatorFound();
+}
+
+}  // namespace
+
+
+void SaucySymmetryFinder::findAutomorphism(Group *group) {
+    SCOPED_TIME_STAT(&_stats.find_time);
+    startSearch();
+
+    SaucySearch search(_graph, _num_vars, group, this);
+    search.run();
+    endSearch();
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,201 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include "cosy/SchreierSims.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cosy {
+
+namespace {
+const int kOut = -1;   // Label of the points out of the orbit
+const int kRoot = -2;  // Label of the base point
+}  // namespace
+
+// The points are the literals of the supports, numbered in index order
+bool SchreierSims::build(
+               const std::vector<std::unique_ptr<Permutation>>& generators,
+               int64 max_words) {
+    std::vector<int> points;
+    for (const std::unique_ptr<Permutation>& generator : generators)
+        for (const Literal& literal : generator->support())
+            points.push_back(literal.index().value());
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    auto point = [&points](const Literal& literal) {
+        return std::lower_bound(points.begin(), points.end(),
+                                literal.index().value()) - points.begin();
+    };
+
+    _num_points = points.size();
+    _max_words = max_words;
+    // The generators and the slots of the random elements
+    if (static_cast<int64>(2 * generators.size() + kSlots + 1) * _num_points >
+        max_words)
+        return false;
+    _words = 0;
+    _strong.clear();
+    _inverses.clear();
+    _levels.clear();
+
+    std::vector<Perm> perms;
+    for (const std::unique_ptr<Permutation>& generator : generators) {
+        Perm g(_num_points);
+        for (int p = 0; p < _num_points; ++p)
+            g[p] = p;
+        for (const Literal& literal : generator->support())
+            g[point(literal)] = point(generator->imageOf(literal));
+        if (!isIdentity(g))
+            perms.push_back(g);
+    }
+    if (perms.empty())
+        return true;
+
+    bool fits = true;
+    for (unsigned int i = 0; fits && i < perms.size(); ++i) {
+        Perm g = perms[i];
+        const int level = sift(&g);
+        fits = level < 0 || extend(g, level);
+    }
+
+    // Each generator has its slot
+    const unsigned int num_slots = std::max<size_t>(kSlots, perms.size());
+    _slots.clear();
+    for (unsigned int i = 0; i < num_slots; ++i)
+        _slots.push_back(perms[i % perms.size()]);
+    _accumulator.resize(_num_points);
+    for (int p = 0; p < _num_points; ++p)
+        _accumulator[p] = p;
+    for (unsigned int i = 0; i < kMixingSteps * num_slots; ++i)
+        random();
+
+    for (int trials = 0; fits && trials < kTrials; ++trials) {
+        Perm g = random();
+        const int level = sift(&g);
+        if (level >= 0) {
+            fits = extend(g, level);
+            trials = -1;
+        }
+    }
+
+    _slots.clear();
+    if (!fits) {
+        _strong.clear();
+        _inverses.clear();
+        _levels.clear();
+    }
+    return fits;
+}
+
+double SchreierSims::log10Order() const {
+    double order = 0;
+    for (const Level& level : _levels)
+        order += std::log10(static_cast<double>(level.orbit.size()));
+    return order;
+}
+
+// Divides g by the coset representatives of the levels. Returns the level
+// whose orbit does not hold the image of the base point, the number of
+// levels if g is not the identity once divided, -1 otherwise.
+int SchreierSims::sift(Perm* g) const {
+    for (unsigned int l = 0; l < _levels.size(); ++l) {
+        const Level& level = _levels[l];
+        int p = (*g)[level.base];
+        if (level.label[p] == kOut)
+            return l;
+        while (p != level.base) {
+            const Perm& inverse = _inverses[level.label[p]];
+            for (int& x : *g)
+                x = inverse[x];
+            p = (*g)[level.base];
+        }
+    }
+    return isIdentity(*g) ? -1 : _levels.size();
+}
+
+// h fixes the base points of the levels before level: it is a strong
+// generator of the levels up to level, a new one if there is none.
+bool SchreierSims::extend(const Perm& h, int level) {
+    const int64 words = _words + 2 * _num_points +
+        (level == static_cast<int>(_levels.size()) ? 2 * _num_points : 0);
+    if (words > _max_words)
+        return false;
+    _words = words;
+
+    if (level == static_cast<int>(_levels.size())) {
+        _levels.emplace_back();
+        Level& last = _levels.back();
+        last.base = 0;
+        while (h[last.base] == last.base)
+            last.base++;
+        last.label.assign(_num_points, kOut);
+        last.label[last.base] = kRoot;
+        last.orbit.push_back(last.base);
+    }
+
+    _strong.push_back(h);
+    _inverses.push_back(inverse(h));
+    for (int l = 0; l <= level; ++l)
+        growOrbit(&_levels[l], _strong.size() - 1);
+    return true;
+}
+
+// The new generator applies to the whole orbit, all the generators of the
+// level to the new points of the orbit
+void SchreierSims::growOrbit(Level* level, int generator) {
+    level->generators.push_back(generator);
+    const size_t size = level->orbit.size();
+    for (size_t i = 0; i < level->orbit.size(); ++i) {
+        for (const int s : level->generators) {
+            if (i < size && s != generator)
+                continue;
+            const int image = _strong[s][level->orbit[i]];
+            if (level->label[image] != kOut)
+                continue;
+            level->label[image] = s;
+            level->orbit.push_back(image);
+        }
+    }
+}
+
+// Product replacement: a slot is multiplied by another one or its inverse,
+// the accumulator by the slot
+SchreierSims::Perm SchreierSims::random() {
+    const int i = _rng() % _slots.size();
+    int j = _rng() % (_slots.size() - 1);
+    if (j >= i)
+        j++;
+
+    const Perm y = (_rng() & 1) ? inverse(_slots[j]) : _slots[j];
+    Perm& x = _slots[i];
+    for (int& image : x)
+        image = y[image];
+    for (int& image : _accumulator)
+        image = x[image];
+    return _accumulator;
+}
+
+// static
+SchreierSims::Perm SchreierSims::inverse(const Perm& g) {
+    Perm inverse(g.size());
+    for (unsigned int p = 0; p < g.size(); ++p)
+        inverse[g[p]] = p;
+    return inverse;
+}
+
+// static
+bool SchreierSims::isIdentity(const Perm& g) {
+    for (unsigned int p = 0; p < g.size(); ++p)
+        if (g[p] != static_cast<int>(p))
+            return false;
+    return true;
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,150 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include "cosy/StaticBreaker.h"
+
+#include <cstdio>
+
+#include "cosy/Printer.h"
+
+namespace cosy {
+
+StaticBreaker::StaticBreaker(const Group& group, const Order& order,
+                             unsigned int num_vars) :
+    _group(group),
+    _order(order),
+    _num_vars(num_vars),
+    _size_limit(0),
+    _matrices_only(false),
+    _num_auxiliary_vars(0),
+    _num_truncated(0),
+    _stamp(0) {
+    _clause_starts.push_back(0);
+}
+
+StaticBreaker::~StaticBreaker() {
+}
+
+void StaticBreaker::generate() {
+    if (_group.numberOfPermutations() == 0)
+        return;
+
+    // The literals of the order moved by each generator, as in CosyManager
+    std::vector< std::vector<Literal> > lookups(_group.numberOfPermutations());
+    for (const Literal& literal : _order)
+        for (const int index : _group.watch(literal.variable()))
+            lookups[index].push_back(literal);
+
+    // The swaps of the matrices are the last generators
+    const unsigned int first_swap = _group.numberOfPermutations() -
+        _group.numberOfAugmentedPermutations();
+    _compared.assign(_num_vars, 0);
+    for (unsigned int g = _matrices_only ? first_swap : 0; g < lookups.size();
+         ++g) {
+        encode(*_group.permutations()[g], lookups[g],
+               g < first_swap ? _size_limit : 0);
+        std::vector<Literal>().swap(lookups[g]);
+    }
+}
+
+void StaticBreaker::encode(const Permutation& generator,
+                           const std::vector<Literal>& lookup,
+                           unsigned int size_limit) {
+    const bool flip = _order.valueMode() == TRUE_LESS_FALSE;
+
+    // The pairs to order, their literals flipped for false < true. The pairs
+    // stop at the first inverting one, which can not be equal.
+    _stamp++;
+    _pairs.clear();
+    for (const Literal& element : lookup) {
+        if (size_limit > 0 && _pairs.size() == size_limit) {
+            _num_truncated++;
+            break;
+        }
+
+        const Literal inverse = generator.inverseOf(element);
+        const Literal x = flip ? element.negated() : element;
+        const Literal y = flip ? inverse.negated() : inverse;
+        if (inverse == element.negated()) {
+            _pairs.emplace_back(x, y);
+            break;
+        }
+
+        // The pair is equal when the one of its 2-cycle, met before, is
+        const bool implied =
+            _compared[inverse.variable().value()] == _stamp &&
+            generator.inverseOf(inverse) == element;
+        _compared[element.variable().value()] = _stamp;
+        if (!implied)
+            _pairs.emplace_back(x, y);
+    }
+
+    Literal equal(kNoLiteralIndex);  // Set after the first pair
+    for (unsigned int i = 0; i < _pairs.size(); ++i) {
+        const Literal x = _pairs[i].first;
+        const Literal y = _pairs[i].second;
+
+        _clause.clear();
+        if (i > 0)
+            _clause.push_back(equal.negated());
+        _clause.push_back(x.negated());
+        if (y != x.negated())
+            _clause.push_back(y);
+        addClause();
+
+        if (i + 1 == _pairs.size())
+            break;
+
+        const Literal next = newAuxiliaryVariable();
+        for (const Literal literal : { x.negated(), y }) {
+            _clause.clear();
+            if (i > 0)
+                _clause.push_back(equal.negated());
+            _clause.push_back(literal);
+            _clause.push_back(next);
+            addClause();
+        }
+        equal = next;
+    }
+}
+
+Literal StaticBreaker::newAuxiliaryVariable() {
+    return Literal(BooleanVariable(_num_vars + _num_auxiliary_vars++), true);
+}
+
+void StaticBreaker::addClause() {
+    _literals.insert(_literals.end(), _clause.begin(), _clause.end());
+    _clause_starts.push_back(_literals.size());
+}
+
+bool StaticBreaker::write(const CNFModel& model,
+                          const std::string& filename) const {
+    FILE* out = fopen(filename.c_str(), "w");
+    if (out == nullptr)
+        return false;
+
+    fprintf(out, "p cnf %u %lld\n", numberOfVariables(),
+            model.clauses().size() + clauses().size());
+    for (const ClauseRange& range : { model.clauses(), clauses() })
+        for (const ClauseView clause : range) {
+            for (const Literal& literal : clause)
+                fprintf(out, "%d ", literal.signedValue());
+            fprintf(out, "0\n");
+        }
+
+    return fclose(out) == 0;
+}
+
+void StaticBreaker::summarize() const {
+    Printer::printStat("Static breaking clauses", clauses().size());
+    Printer::printStat(" |- auxiliary variables", numberOfAuxiliaryVariables());
+    Printer::printStat(" |- truncated generators", _num_truncated);
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
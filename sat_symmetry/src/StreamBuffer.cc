@@ -2,6 +2,11 @@
 
 #include "cosy/StreamBuffer.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace cosy {
 
 StreamBuffer::StreamBuffer(const std::string& filename) :
@@ -11,18 +16,52 @@ StreamBuffer::StreamBuffer(const std::string& filename) :
 StreamBuffer::StreamBuffer(const char* filename) :
         _filename(filename),
         _in(nullptr),
+        _data(nullptr),
         _index(0),
-        _size(0) {
+        _size(0),
+        _mapped(nullptr) {
+    if (map(filename))
+        return;
     _in = gzopen(filename, "rb");
     if (_in == nullptr)
         LOG(FATAL) << "Cannot open file " << filename;
+    _reader.reset(new GzipReader(_in));
     read();
 }
 
 StreamBuffer::~StreamBuffer() {
+    _reader.reset();
     if (_in != nullptr) {
         gzclose(_in);
     }
+    if (_mapped != nullptr) {
+        munmap(_mapped, _size);
+    }
+}
+
+// Maps filename when it is an uncompressed regular file
+bool StreamBuffer::map(const char* filename) {
+    const int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            const unsigned char* head = static_cast<unsigned char*>(addr);
+            if (st.st_size >= 2 && head[0] == 0x1f && head[1] == 0x8b) {
+                munmap(addr, st.st_size);
+            } else {
+                madvise(addr, st.st_size, MADV_SEQUENTIAL);
+                _mapped = addr;
+                _data = head;
+                _size = st.st_size;
+            }
+        }
+    }
+    close(fd);
+    return _mapped != nullptr;
 }
 
 
@@ -42,7 +81,7 @@ int StreamBuffer::readInt() {
     }
 
     while ((c = read()) != '\0' &&  c >= '0' && c <= '9') {
-        value = (value * 10) + (_buffer[_index] - '0');
+        value = (value * 10) + (c - '0');
         ++(*this);
     }
 
@@ -77,11 +116,13 @@ void StreamBuffer::operator++() {
 }
 
 unsigned char StreamBuffer::read() {
-    if (_index >= _size) {
-        _size = gzread(_in, _buffer, sizeof(_buffer));
+    if (_index >= _size && _mapped == nullptr) {
+        unsigned int size;
+        _data = _reader->next(&size);
+        _size = size;
         _index = 0;
     }
-    return (_index >= _size) ? '\0' : _buffer[_index];
+    return (_index >= _size) ? '\0' : _data[_index];
 }
 
 }  // namespace cosy
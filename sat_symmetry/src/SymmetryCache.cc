@@ -0,0 +1,203 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include "cosy/SymmetryCache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "cosy/AutomorphismChecker.h"
+#include "cosy/Printer.h"
+#include "cosy/SaucyReader.h"
+
+namespace cosy {
+
+namespace {
+const char kEntrySuffix[] = ".sym";
+const char kTotalsFile[] = "stats";
+
+bool hasEntrySuffix(const std::string& name) {
+    const size_t n = sizeof(kEntrySuffix) - 1;
+    return name.size() > n &&
+        name.compare(name.size() - n, n, kEntrySuffix) == 0;
+}
+}  // namespace
+
+SymmetryCache::SymmetryCache(const std::string& directory, int64 max_bytes) :
+    _directory(directory),
+    _max_bytes(max_bytes) {
+    mkdir(directory.c_str(), 0755);
+}
+
+std::string SymmetryCache::entry(const CNFModel& model, int tool) const {
+    return _directory + "/" + model.fingerprint() + "-" + std::to_string(tool)
+        + kEntrySuffix;
+}
+
+// The fingerprint only identifies the model up to collisions, and the entry
+// may be truncated or damaged: the generators are added to group only once
+// they are all read and checked to be automorphisms of model. A bad entry
+// is removed and counts as a miss.
+bool SymmetryCache::lookup(const CNFModel& model, int tool,
+                           unsigned int num_vars, Group* group) {
+    const std::string filename = entry(model, tool);
+    struct stat st;
+
+    if (stat(filename.c_str(), &st) != 0) {
+        _stats.misses.increment();
+        addToTotals(0, 1, 0);
+        return false;
+    }
+
+    SaucyReader reader;
+    std::vector<std::unique_ptr<Permutation>> generators;
+    bool valid = reader.read(filename, num_vars, &generators);
+    AutomorphismChecker checker(model, num_vars);
+    for (unsigned int g = 0; valid && g < generators.size(); ++g)
+        valid = checker.isAutomorphism(*generators[g]);
+    if (!valid) {
+        LOG(ERROR) << "Symmetry cache entry " << filename
+                   << " is not valid, removed.";
+        unlink(filename.c_str());
+        _stats.misses.increment();
+        addToTotals(0, 1, 0);
+        return false;
+    }
+
+    for (std::unique_ptr<Permutation>& generator : generators)
+        group->addPermutation(std::move(generator));
+    utime(filename.c_str(), nullptr);  // Most recently used
+    _stats.hits.increment();
+    addToTotals(1, 0, 0);
+    return true;
+}
+
+// The entry is written in Saucy format under a temporary name then renamed,
+// so that a concurrent run never reads a partial entry.
+void SymmetryCache::store(const CNFModel& model, int tool,
+                          unsigned int num_vars, const Group& group) {
+    const std::string filename = entry(model, tool);
+    const std::string tmp = filename + "." + std::to_string(getpid());
+
+    FILE* out = fopen(tmp.c_str(), "w");
+    if (out == nullptr) {
+        LOG(ERROR) << "Cannot write symmetry cache entry " << tmp;
+        return;
+    }
+
+    const std::vector<std::unique_ptr<Permutation>>& generators =
+        group.permutations();
+    fprintf(out, "[\n");
+    for (unsigned int g = 0; g < generators.size(); ++g) {
+        const Permutation& permutation = *generators[g];
+        for (unsigned int c = 0; c < permutation.numberOfCycles(); ++c) {
+            const char* separator = "(";
+            for (const Literal& literal : permutation.cycle(c)) {
+                const int value = literal.signedValue();
+                fprintf(out, "%s%d", separator,
+                        value > 0 ? value : static_cast<int>(num_vars) - value);
+                separator = ",";
+            }
+            fprintf(out, ")");
+        }
+        fprintf(out, g + 1 < generators.size() ? ",\n" : "\n");
+    }
+    fprintf(out, "]\n");
+
+    if (fclose(out) != 0 || rename(tmp.c_str(), filename.c_str()) != 0) {
+        LOG(ERROR) << "Cannot write symmetry cache entry " << filename;
+        unlink(tmp.c_str());
+        return;
+    }
+    evict();
+}
+
+void SymmetryCache::evict() {
+    DIR* dir = opendir(_directory.c_str());
+    if (dir == nullptr)
+        return;
+
+    std::vector<std::pair<time_t, std::string>> entries;
+    int64 total = 0;
+    struct dirent* file;
+    while ((file = readdir(dir)) != nullptr) {
+        const std::string name = file->d_name;
+        struct stat st;
+        if (!hasEntrySuffix(name) ||
+            stat((_directory + "/" + name).c_str(), &st) != 0)
+            continue;
+        entries.emplace_back(st.st_mtime, name);
+        total += st.st_size;
+    }
+    closedir(dir);
+    if (total <= _max_bytes)
+        return;
+
+    // Least recently used first
+    std::sort(entries.begin(), entries.end());
+    int64 evicted = 0;
+    for (const std::pair<time_t, std::string>& e : entries) {
+        if (total <= _max_bytes)
+            break;
+        const std::string filename = _directory + "/" + e.second;
+        struct stat st;
+        if (stat(filename.c_str(), &st) != 0 || unlink(filename.c_str()) != 0)
+            continue;
+        total -= st.st_size;
+        evicted++;
+        _stats.evictions.increment();
+    }
+    addToTotals(0, 0, evicted);
+}
+
+// Runs sharing the directory update the totals under an exclusive lock of
+// the file, so that no update is lost
+void SymmetryCache::addToTotals(int64 hits, int64 misses, int64 evictions) {
+    const std::string filename = _directory + "/" + kTotalsFile;
+    long long totals[3] = { 0, 0, 0 };  // NOLINT
+
+    const int fd = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return;
+    if (flock(fd, LOCK_EX) != 0) {
+        close(fd);
+        return;
+    }
+
+    char buffer[128];
+    const ssize_t n = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    buffer[n > 0 ? n : 0] = '\0';
+    if (sscanf(buffer, "%lld %lld %lld", &totals[0], &totals[1],
+               &totals[2]) != 3)
+        totals[0] = totals[1] = totals[2] = 0;
+
+    const int size = snprintf(buffer, sizeof(buffer), "%lld %lld %lld\n",
+                              totals[0] + hits, totals[1] + misses,
+                              totals[2] + evictions);
+    if (ftruncate(fd, 0) != 0 || pwrite(fd, buffer, size, 0) != size)
+        LOG(ERROR) << "Cannot update the symmetry cache totals " << filename;
+    close(fd);  // Releases the lock
+}
+
+void SymmetryCache::printStats() const {
+    Printer::printStat("Symmetry cache", _directory);
+    _stats.print();
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
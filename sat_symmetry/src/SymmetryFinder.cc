@@ -1,6 +1,11 @@
 // Copyright 2017 Hakan Metin - LIP6
 
 #include "cosy/SymmetryFinder.h"
+
+#include <sys/resource.h>
+
+#include <utility>
+
 #include "cosy/BlissSymmetryFinder.h"
 #include "cosy/SaucySymmetryFinder.h"
 
@@ -17,4 +22,28 @@ SymmetryFinder::create(const CNFModel& model,
     }
 }
 
+void SymmetryFinder::addGenerator(Group *group,
+                                  std::unique_ptr<Permutation>&& generator) {
+    if (_checker == nullptr)
+        _checker = std::unique_ptr<AutomorphismChecker>
+            (new AutomorphismChecker(_model, _num_vars));
+    generator->build();
+    if (!_checker->isAutomorphism(*generator)) {
+        _rejected++;
+        return;
+    }
+    group->addPermutation(std::move(generator));
+}
+
+// The peak resident memory of the process, which includes the graphs of the
+// automorphism tool
+void SymmetryFinder::endSearch() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    _peak_memory = usage.ru_maxrss / 1024.0;
+    if (_rejected > 0)
+        LOG(ERROR) << toolName() << " found " << _rejected
+                   << " generators which are not automorphisms of the model";
+}
+
 }  // namespace cosy
@@ -0,0 +1,54 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "cosy/AutomorphismChecker.h"
+
+namespace cosy {
+
+static void addClause(CNFModel* model, std::vector<Literal> literals) {
+    model->addClause(&literals);
+}
+
+static std::unique_ptr<Permutation>
+permutation(const std::vector<std::vector<Literal>>& cycles) {
+    std::unique_ptr<Permutation> p(new Permutation(3));
+    for (const std::vector<Literal>& cycle : cycles) {
+        for (const Literal& literal : cycle)
+            p->addToCurrentCycle(literal);
+        p->closeCurrentCycle();
+    }
+    p->build();
+    return p;
+}
+
+// At most one of 1, 2, 3 is true, at least one of 1, 2 is true
+TEST(AutomorphismCheckerTest, MapsClausesOntoClauses) {
+    CNFModel model;
+    addClause(&model, {1, 2});
+    addClause(&model, {-1, -2});
+    addClause(&model, {-1, -3});
+    addClause(&model, {-2, -3});
+    AutomorphismChecker checker(model, 3);
+
+    EXPECT_TRUE(checker.isAutomorphism(*permutation({{1, 2}, {-1, -2}})));
+    EXPECT_TRUE(checker.isAutomorphism(*permutation({})));
+    EXPECT_FALSE(checker.isAutomorphism(*permutation({{1, 3}, {-1, -3}})));
+    EXPECT_FALSE(checker.isAutomorphism(*permutation({{1, -1}})));
+    EXPECT_FALSE(checker.isAutomorphism(*permutation({{1, 2, 3},
+                                                      {-1, -2, -3}})));
+    // The checks are independent
+    EXPECT_TRUE(checker.isAutomorphism(*permutation({{-1, -2}, {1, 2}})));
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
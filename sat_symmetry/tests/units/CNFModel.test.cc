@@ -0,0 +1,72 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+#include "cosy/CNFModel.h"
+
+namespace cosy {
+
+static void addClause(CNFModel* model, std::vector<Literal> literals) {
+    model->addClause(&literals);
+}
+
+static bool hasClause(const CNFModel& model, std::vector<Literal> literals) {
+    std::sort(literals.begin(), literals.end());
+    return model.hasClause(literals);
+}
+
+// The clauses read are not those of the header
+static void checkModel(const CNFModel& model) {
+    EXPECT_EQ(model.numberOfVariables(), 3);
+    EXPECT_EQ(model.numberOfClauses(), 4);
+    EXPECT_TRUE(hasClause(model, {1, 2}));
+    EXPECT_TRUE(hasClause(model, {-3, 2}));
+    EXPECT_FALSE(hasClause(model, {1, 3}));
+    EXPECT_EQ(model.occurences()[1], 2);  // Of 2
+}
+
+static void addClauses(CNFModel* model) {
+    addClause(model, {1, 2});
+    addClause(model, {2, -3});
+    addClause(model, {1, 2});
+    addClause(model, {3});
+}
+
+// "p cnf 2147483647 2147483647" must not allocate for the header
+TEST(CNFModelTest, OverClaimingHeader) {
+    CNFModel model;
+    model.reserve(INT32_MAX, INT32_MAX);
+    addClauses(&model);
+    checkModel(model);
+}
+
+TEST(CNFModelTest, UnderClaimingHeader) {
+    CNFModel model;
+    model.reserve(1, 1);
+    addClauses(&model);
+    checkModel(model);
+}
+
+TEST(CNFModelTest, GrowsPastTheHeader) {
+    CNFModel model;
+    model.reserve(2, 2);
+    for (int v = 1; v < 5000; ++v)
+        addClause(&model, {v, v + 1});
+    EXPECT_EQ(model.numberOfVariables(), 5000);
+    EXPECT_EQ(model.numberOfClauses(), 4999);
+    for (int v = 1; v < 5000; ++v)
+        EXPECT_TRUE(hasClause(model, {v, v + 1}));
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
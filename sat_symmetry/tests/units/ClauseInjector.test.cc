@@ -0,0 +1,52 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "cosy/ClauseInjector.h"
+
+namespace cosy {
+
+static std::vector<Literal> literals(const ClauseView& clause) {
+    return std::vector<Literal>(clause.begin(), clause.end());
+}
+
+// The last pending clause taken empties the arena: its view must still read
+// its literals
+TEST(InjectorTest, LastClauseTaken) {
+    Injector injector;
+    injector.resize(4);
+    const std::vector<Literal> clause = {1, -2, 3};
+    injector.addClause(BooleanVariable(2), clause);
+    EXPECT_EQ(literals(injector.takeClause(BooleanVariable(2))), clause);
+    EXPECT_FALSE(injector.hasClause(BooleanVariable(2)));
+
+    const std::vector<Literal> unbound = {-4, 1};
+    injector.addClause(kNoBooleanVariable, unbound);
+    EXPECT_EQ(literals(injector.takeClause(kNoBooleanVariable)), unbound);
+    EXPECT_FALSE(injector.hasClause(kNoBooleanVariable));
+}
+
+// Taken clauses are compacted away, the pending ones are kept
+TEST(InjectorTest, Compaction) {
+    Injector injector;
+    injector.resize(2);
+    const std::vector<Literal> pending = {1, 2};
+    injector.addClause(BooleanVariable(0), pending);
+    for (int i = 0; i < 1000; ++i) {
+        const std::vector<Literal> clause = {-2, i % 2 ? 1 : -1};
+        injector.addClause(BooleanVariable(1), clause);
+        EXPECT_EQ(literals(injector.takeClause(BooleanVariable(1))), clause);
+    }
+    EXPECT_EQ(literals(injector.takeClause(BooleanVariable(0))), pending);
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,100 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "cosy/GzipReader.h"
+
+namespace cosy {
+
+class GzipReaderTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        char name[] = "/tmp/cosy-gzip-XXXXXX";
+        const int fd = mkstemp(name);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        _filename = name;
+
+        // Several buffers of the ring, and a partial one
+        for (int i = 0; _content.size() < (1 << 20) + 12345; ++i)
+            _content += std::to_string(i * 2654435761u % 100003) + " 0\n";
+    }
+    void TearDown() override { unlink(_filename.c_str()); }
+
+    void write(const char* mode) {
+        gzFile out = gzopen(_filename.c_str(), mode);
+        ASSERT_NE(out, nullptr);
+        gzwrite(out, _content.data(), _content.size());
+        gzclose(out);
+    }
+
+    std::string read(bool background, bool* threaded) {
+        gzFile in = gzopen(_filename.c_str(), "rb");
+        std::string content;
+        {
+            GzipReader reader(in, background);
+            *threaded = reader.threaded();
+            unsigned int size;
+            const unsigned char* buffer;
+            while ((buffer = reader.next(&size)) != nullptr)
+                content.append(reinterpret_cast<const char*>(buffer), size);
+            EXPECT_EQ(reader.next(&size), nullptr);
+            EXPECT_EQ(size, 0);
+        }
+        gzclose(in);
+        return content;
+    }
+
+    std::string _filename;
+    std::string _content;
+};
+
+TEST_F(GzipReaderTest, Background) {
+    write("wb");
+    bool threaded;
+    EXPECT_EQ(read(true, &threaded), _content);
+    EXPECT_TRUE(threaded);
+}
+
+TEST_F(GzipReaderTest, Foreground) {
+    write("wb");
+    bool threaded;
+    EXPECT_EQ(read(false, &threaded), _content);
+    EXPECT_FALSE(threaded);
+}
+
+// Nothing to inflate: no thread
+TEST_F(GzipReaderTest, Uncompressed) {
+    write("wT");
+    bool threaded;
+    EXPECT_EQ(read(true, &threaded), _content);
+    EXPECT_FALSE(threaded);
+}
+
+// The thread, blocked on a full ring, is stopped by the destructor
+TEST_F(GzipReaderTest, StopsBeforeTheEnd) {
+    write("wb");
+    gzFile in = gzopen(_filename.c_str(), "rb");
+    {
+        GzipReader reader(in, true);
+        unsigned int size;
+        ASSERT_NE(reader.next(&size), nullptr);
+        EXPECT_GT(size, 0);
+    }
+    gzclose(in);
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
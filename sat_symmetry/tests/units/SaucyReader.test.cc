@@ -0,0 +1,115 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cosy/SaucyReader.h"
+
+namespace cosy {
+
+class SaucyReaderTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        char name[] = "/tmp/cosy-saucy-XXXXXX";
+        const int fd = mkstemp(name);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        _filename = name;
+    }
+    void TearDown() override { unlink(_filename.c_str()); }
+
+    void write(const std::string& content) {
+        FILE* out = fopen(_filename.c_str(), "w");
+        ASSERT_NE(out, nullptr);
+        fwrite(content.data(), 1, content.size(), out);
+        fclose(out);
+    }
+
+    bool read(unsigned int num_vars) {
+        SaucyReader reader;
+        return reader.read(_filename, num_vars, &_generators);
+    }
+
+    std::string _filename;
+    std::vector<std::unique_ptr<Permutation>> _generators;
+};
+
+// 3 variables: nodes 1..3 are the positive literals, 4..6 the negative
+// ones, from 7 the clauses
+static const char kWellFormed[] = "[\n(1,2)(4,5)(7,8),\n(1,3)(4,6)\n]\n";
+
+TEST_F(SaucyReaderTest, ReadsGenerators) {
+    write(kWellFormed);
+    ASSERT_TRUE(read(3));
+    ASSERT_EQ(_generators.size(), 2u);
+
+    const Permutation& first = *_generators[0];
+    EXPECT_EQ(first.numberOfCycles(), 2u);  // The clause cycle is dropped
+    EXPECT_EQ(first.imageOf(Literal(1)), Literal(2));
+    EXPECT_EQ(first.imageOf(Literal(-2)), Literal(-1));
+    EXPECT_EQ(first.imageOf(Literal(3)), Literal(3));
+    EXPECT_EQ(_generators[1]->imageOf(Literal(-1)), Literal(-3));
+}
+
+TEST_F(SaucyReaderTest, ReadsNoGenerator) {
+    write("[\n]\n");
+    EXPECT_TRUE(read(3));
+    EXPECT_TRUE(_generators.empty());
+}
+
+TEST_F(SaucyReaderTest, RejectsEveryTruncation) {
+    const std::string content = kWellFormed;
+    // Without the final newline the file is still complete
+    for (size_t size = 0; size + 1 < content.size(); ++size) {
+        write(content.substr(0, size));
+        EXPECT_FALSE(read(3)) << "size " << size;
+        EXPECT_TRUE(_generators.empty());
+    }
+}
+
+TEST_F(SaucyReaderTest, RejectsNonPermutations) {
+    const char* malformed[] = {
+        "[\n(1,2)(2,3)\n]\n",      // 2 is mapped twice
+        "[\n(1,1)\n]\n",           // Not a cycle
+        "[\n(1)\n]\n",             // Idem
+        "[\n(1,7)\n]\n",           // Literal and clause nodes mixed
+        "[\n(0,1)\n]\n",           // Nodes start at 1
+        "[\n(1,-2)\n]\n",
+        "[\n(1,99999999999)\n]\n",
+        "[\n(1,2),\n]\n",
+        "[\n(1,2)\n",
+        "[\n(1,2)(4,5)x\n]\n",
+    };
+    for (const char* content : malformed) {
+        write(content);
+        EXPECT_FALSE(read(3)) << content;
+        EXPECT_TRUE(_generators.empty());
+    }
+}
+
+TEST_F(SaucyReaderTest, LoadAddsNothingOnError) {
+    write("[\n(1,2)(4,5),\n(1,3)(1,6)\n]\n");
+    SaucyReader reader;
+    Group group;
+    EXPECT_FALSE(reader.load(_filename, 3, &group));
+    EXPECT_EQ(group.numberOfPermutations(), 0);
+
+    write(kWellFormed);
+    EXPECT_TRUE(reader.load(_filename, 3, &group));
+    EXPECT_EQ(group.numberOfPermutations(), 2);
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
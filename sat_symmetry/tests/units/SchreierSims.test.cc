@@ -0,0 +1,84 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "cosy/SchreierSims.h"
+
+namespace cosy {
+
+// Adds the permutation of the variables given by its cycles, and the same
+// permutation of their negations
+static void add(std::vector<std::unique_ptr<Permutation>>* generators,
+                const std::vector<std::vector<int>>& cycles) {
+    std::unique_ptr<Permutation> p(new Permutation(16));
+    for (const int sign : {1, -1}) {
+        for (const std::vector<int>& cycle : cycles) {
+            for (const int variable : cycle)
+                p->addToCurrentCycle(Literal(sign * variable));
+            p->closeCurrentCycle();
+        }
+    }
+    p->build();
+    generators->push_back(std::move(p));
+}
+
+static double order(
+        const std::vector<std::unique_ptr<Permutation>>& generators) {
+    SchreierSims chain;
+    EXPECT_TRUE(chain.build(generators, 1 << 20));
+    return std::pow(10, chain.log10Order());
+}
+
+TEST(SchreierSimsTest, TrivialGroup) {
+    std::vector<std::unique_ptr<Permutation>> generators;
+    EXPECT_NEAR(order(generators), 1, 1e-6);
+}
+
+TEST(SchreierSimsTest, SymmetricGroup) {
+    std::vector<std::unique_ptr<Permutation>> generators;
+    add(&generators, {{1, 2}});
+    add(&generators, {{1, 2, 3, 4, 5, 6, 7}});
+    EXPECT_NEAR(order(generators), 5040, 1e-6);
+}
+
+TEST(SchreierSimsTest, CyclicGroup) {
+    std::vector<std::unique_ptr<Permutation>> generators;
+    add(&generators, {{1, 2, 3, 4}, {5, 6, 7}});
+    EXPECT_NEAR(order(generators), 12, 1e-6);
+}
+
+// Pigeons 1, 2, 3 in holes 1, 2: variable 2 (p - 1) + h. The pigeons
+// are permuted by S3 and the holes by S2.
+TEST(SchreierSimsTest, PigeonHoleGroup) {
+    std::vector<std::unique_ptr<Permutation>> generators;
+    add(&generators, {{1, 3}, {2, 4}});
+    add(&generators, {{3, 5}, {4, 6}});
+    add(&generators, {{1, 2}, {3, 4}, {5, 6}});
+    EXPECT_NEAR(order(generators), 12, 1e-6);
+
+    // Redundant generators do not change the order
+    add(&generators, {{1, 5}, {2, 6}});
+    add(&generators, {{1, 4, 5, 2, 3, 6}});
+    EXPECT_NEAR(order(generators), 12, 1e-6);
+}
+
+TEST(SchreierSimsTest, ChainTooLarge) {
+    std::vector<std::unique_ptr<Permutation>> generators;
+    add(&generators, {{1, 2, 3, 4, 5, 6, 7, 8}});
+    SchreierSims chain;
+    EXPECT_FALSE(chain.build(generators, 16));
+    EXPECT_EQ(chain.baseLength(), 0u);
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
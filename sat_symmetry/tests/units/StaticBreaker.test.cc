@@ -0,0 +1,145 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "cosy/Matrixes.h"
+#include "cosy/OrderFactory.h"
+#include "cosy/StaticBreaker.h"
+#include "cosy/SymmetryFinder.h"
+
+namespace cosy {
+
+class StaticBreakerTest : public ::testing::Test {
+ protected:
+    void addClause(std::vector<Literal> literals) {
+        _model.addClause(&literals);
+    }
+
+    // n pigeons in n holes: the solutions are the permutation matrices
+    void addPigeonHole(int n) {
+        for (int p = 0; p < n; ++p) {
+            std::vector<Literal> clause;
+            for (int h = 0; h < n; ++h)
+                clause.push_back(p * n + h + 1);
+            addClause(clause);
+        }
+        for (int h = 0; h < n; ++h)
+            for (int p = 0; p < n; ++p)
+                for (int q = p + 1; q < n; ++q)
+                    addClause({-(p * n + h + 1), -(q * n + h + 1)});
+    }
+
+    void breakSymmetries(bool matrices_only) {
+        std::unique_ptr<SymmetryFinder> finder(
+            SymmetryFinder::create(_model, SymmetryFinder::BLISS));
+        finder->findAutomorphism(&_group);
+        _matrixes.reset(new Matrixes(_model));
+        _matrixes->detect(_group);
+        _matrixes->augment(&_group);
+        _order.reset(OrderFactory::create(AUTO, TRUE_LESS_FALSE, _model,
+                                          _group, _matrixes.get()));
+        _breaker.reset(new StaticBreaker(_group, *_order,
+                                         _model.numberOfVariables()));
+        _breaker->setMatricesOnly(matrices_only);
+        _breaker->generate();
+    }
+
+    static bool satisfies(const ClauseView& clause,
+                          const std::vector<bool>& value) {
+        for (const Literal& literal : clause)
+            if (value[literal.variable().value()] == literal.isPositive())
+                return true;
+        return false;
+    }
+
+    static bool satisfies(const ClauseRange& clauses,
+                          const std::vector<bool>& value) {
+        for (const ClauseView clause : clauses)
+            if (!satisfies(clause, value))
+                return false;
+        return true;
+    }
+
+    // Solutions of the model kept by the breaking clauses. The auxiliary
+    // variables only appear positive in the clauses implying them: they are
+    // set by a fixpoint.
+    int countSolutions() const {
+        const unsigned int num_vars = _model.numberOfVariables();
+        int count = 0;
+        for (uint64 bits = 0; bits < (uint64(1) << num_vars); ++bits) {
+            std::vector<bool> value(_breaker->numberOfVariables(), false);
+            for (unsigned int v = 0; v < num_vars; ++v)
+                value[v] = (bits >> v) & 1;
+            if (!satisfies(_model.clauses(), value))
+                continue;
+            for (bool changed = true; changed;) {
+                changed = false;
+                for (const ClauseView clause : _breaker->clauses()) {
+                    if (satisfies(clause, value))
+                        continue;
+                    for (const Literal& literal : clause)
+                        if (static_cast<unsigned int>(
+                                literal.variable().value()) >= num_vars &&
+                            literal.isPositive())
+                            value[literal.variable().value()] = changed =
+                                true;
+                }
+            }
+            if (satisfies(_breaker->clauses(), value))
+                count++;
+        }
+        return count;
+    }
+
+    CNFModel _model;
+    Group _group;
+    std::unique_ptr<Matrixes> _matrixes;
+    std::unique_ptr<Order> _order;
+    std::unique_ptr<StaticBreaker> _breaker;
+};
+
+TEST_F(StaticBreakerTest, MatrixChainsKeepOneSolution) {
+    addPigeonHole(4);
+    breakSymmetries(true);
+    ASSERT_EQ(_matrixes->size(), 1);
+    EXPECT_EQ(_matrixes->matrix(0).numberOfRows(), 4);
+    // Three row swaps and three column swaps of 4 pairs, 3 * 4 - 2 clauses
+    EXPECT_EQ(_group.numberOfAugmentedPermutations(), 6);
+    EXPECT_EQ(_breaker->clauses().size(), 6 * 10);
+    EXPECT_EQ(_breaker->numberOfAuxiliaryVariables(), 6 * 3);
+    EXPECT_EQ(countSolutions(), 1);
+}
+
+// The generators and the swaps on the same order: still one solution
+TEST_F(StaticBreakerTest, GeneratorsAndMatrixChains) {
+    addPigeonHole(3);
+    breakSymmetries(false);
+    EXPECT_GT(_breaker->clauses().size(), 4 * 7);
+    EXPECT_EQ(countSolutions(), 1);
+}
+
+// Not all equal: a column of three interchangeable variables, sorted with
+// one clause per swap. The inversion is not a swap, one solution is kept per
+// number of true variables.
+TEST_F(StaticBreakerTest, SingleColumn) {
+    addClause({1, 2, 3});
+    addClause({-1, -2, -3});
+    breakSymmetries(true);
+    ASSERT_EQ(_matrixes->size(), 1);
+    EXPECT_EQ(_matrixes->matrix(0).numberOfColumns(), 1);
+    EXPECT_EQ(_breaker->clauses().size(), 2);
+    EXPECT_EQ(_breaker->numberOfAuxiliaryVariables(), 0);
+    EXPECT_EQ(countSolutions(), 2);
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,134 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cosy/SymmetryCache.h"
+
+namespace cosy {
+
+class SymmetryCacheTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        char name[] = "/tmp/cosy-cache-XXXXXX";
+        ASSERT_NE(mkdtemp(name), nullptr);
+        _directory = name;
+
+        // Pigeon hole 3 x 2: pigeon i in hole j is variable 2i + j + 1
+        for (int i = 0; i < 3; ++i)
+            addClause({2 * i + 1, 2 * i + 2});
+        for (int j = 0; j < 2; ++j)
+            for (int i = 0; i < 3; ++i)
+                for (int k = i + 1; k < 3; ++k)
+                    addClause({-(2 * i + j + 1), -(2 * k + j + 1)});
+
+        // Swap of pigeons 0 and 1, swap of the holes
+        _generators.push_back({{1, 3}, {2, 4}, {-1, -3}, {-2, -4}});
+        _generators.push_back({{1, 2}, {3, 4}, {5, 6},
+                               {-1, -2}, {-3, -4}, {-5, -6}});
+    }
+
+    void TearDown() override {
+        const std::string command = "rm -rf " + _directory;
+        ASSERT_EQ(system(command.c_str()), 0);
+    }
+
+    void addClause(std::vector<Literal> literals) {
+        _model.addClause(&literals);
+    }
+
+    void fill(Group* group) {
+        for (const std::vector<std::vector<Literal>>& cycles : _generators) {
+            std::unique_ptr<Permutation> p(new Permutation(kNumVars));
+            for (const std::vector<Literal>& cycle : cycles) {
+                for (const Literal& literal : cycle)
+                    p->addToCurrentCycle(literal);
+                p->closeCurrentCycle();
+            }
+            group->addPermutation(std::move(p));
+        }
+    }
+
+    std::string entry() const {
+        return _directory + "/" + _model.fingerprint() + "-0.sym";
+    }
+
+    std::string totals() const {
+        FILE* in = fopen((_directory + "/stats").c_str(), "r");
+        char line[128] = "";
+        if (in != nullptr) {
+            if (fgets(line, sizeof(line), in) == nullptr)
+                line[0] = '\0';
+            fclose(in);
+        }
+        return line;
+    }
+
+    static const unsigned int kNumVars = 6;
+    std::string _directory;
+    CNFModel _model;
+    std::vector<std::vector<std::vector<Literal>>> _generators;
+};
+
+TEST_F(SymmetryCacheTest, StoresAndFinds) {
+    SymmetryCache cache(_directory, 1 << 20);
+    Group empty, stored, found;
+
+    EXPECT_FALSE(cache.lookup(_model, 0, kNumVars, &empty));
+    fill(&stored);
+    cache.store(_model, 0, kNumVars, stored);
+    ASSERT_TRUE(cache.lookup(_model, 0, kNumVars, &found));
+    EXPECT_EQ(found.numberOfPermutations(), 2);
+    EXPECT_EQ(totals(), "1 1 0\n");
+}
+
+TEST_F(SymmetryCacheTest, TruncatedEntryIsAMiss) {
+    SymmetryCache cache(_directory, 1 << 20);
+    Group stored;
+    fill(&stored);
+    cache.store(_model, 0, kNumVars, stored);
+
+    // Keeps the first generator and part of the second one
+    FILE* in = fopen(entry().c_str(), "r");
+    ASSERT_NE(in, nullptr);
+    char content[256];
+    const size_t size = fread(content, 1, sizeof(content), in);
+    fclose(in);
+    ASSERT_EQ(truncate(entry().c_str(), size - 8), 0);
+
+    Group group;
+    EXPECT_FALSE(cache.lookup(_model, 0, kNumVars, &group));
+    EXPECT_EQ(group.numberOfPermutations(), 0);
+    EXPECT_NE(access(entry().c_str(), F_OK), 0);  // Removed
+    EXPECT_EQ(totals(), "0 1 0\n");
+}
+
+// An entry of another model under the same name, as for a collision of
+// the fingerprints
+TEST_F(SymmetryCacheTest, EntryOfAnotherModelIsAMiss) {
+    FILE* out = fopen(entry().c_str(), "w");
+    ASSERT_NE(out, nullptr);
+    fprintf(out, "[\n(1,3)(7,9),\n(1,5)(7,11)\n]\n");  // First hole only
+    fclose(out);
+
+    SymmetryCache cache(_directory, 1 << 20);
+    Group group;
+    EXPECT_FALSE(cache.lookup(_model, 0, kNumVars, &group));
+    EXPECT_EQ(group.numberOfPermutations(), 0);
+    EXPECT_EQ(totals(), "0 1 0\n");
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
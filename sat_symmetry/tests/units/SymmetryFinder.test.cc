@@ -0,0 +1,107 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "cosy/AutomorphismChecker.h"
+#include "cosy/SymmetryFinder.h"
+
+namespace cosy {
+
+class SymmetryFinderTest :
+        public ::testing::TestWithParam<SymmetryFinder::Automorphism> {
+ protected:
+    void addClause(std::vector<Literal> literals) {
+        _model.addClause(&literals);
+    }
+
+    // Pigeon p in hole h is variable p * holes + h + 1
+    void addPigeonHole(int pigeons, int holes, int first_variable) {
+        for (int p = 0; p < pigeons; ++p) {
+            std::vector<Literal> clause;
+            for (int h = 0; h < holes; ++h)
+                clause.push_back(first_variable + p * holes + h);
+            addClause(clause);
+        }
+        for (int h = 0; h < holes; ++h)
+            for (int p = 0; p < pigeons; ++p)
+                for (int q = p + 1; q < pigeons; ++q)
+                    addClause({-(first_variable + p * holes + h),
+                               -(first_variable + q * holes + h)});
+    }
+
+    // Finds the group, checks its generators and returns its order
+    double findOrder(const SymmetryFinder::Budget& budget =
+                     SymmetryFinder::Budget()) {
+        std::unique_ptr<SymmetryFinder> finder(
+            SymmetryFinder::create(_model, GetParam()));
+        finder->setBudget(budget);
+        _group.reset(new Group());
+        finder->findAutomorphism(_group.get());
+        EXPECT_TRUE(finder->complete());
+
+        const unsigned int num_vars = _model.numberOfVariables();
+        AutomorphismChecker checker(_model, num_vars);
+        for (const std::unique_ptr<Permutation>& generator :
+                 _group->permutations())
+            EXPECT_TRUE(checker.isAutomorphism(*generator));
+        return std::pow(10, _group->log10Order(1 << 20));
+    }
+
+    CNFModel _model;
+    std::unique_ptr<Group> _group;
+};
+
+TEST_P(SymmetryFinderTest, PigeonHole) {
+    addPigeonHole(5, 4, 1);
+    EXPECT_NEAR(findOrder(), 120 * 24, 1e-6);
+}
+
+// Not all equal: the variables are permuted and all inverted together
+TEST_P(SymmetryFinderTest, InvertingSymmetries) {
+    addClause({1, 2, 3});
+    addClause({-1, -2, -3});
+    EXPECT_NEAR(findOrder(), 6 * 2, 1e-6);
+}
+
+// The same component twice: the components are interchanged
+TEST_P(SymmetryFinderTest, IsomorphicComponents) {
+    addPigeonHole(3, 2, 1);
+    addPigeonHole(3, 2, 7);
+    EXPECT_NEAR(findOrder(), 12 * 12 * 2, 1e-6);
+}
+
+// The components searched on one thread and on two
+TEST_P(SymmetryFinderTest, Threads) {
+    for (int c = 0; c < 4; ++c)
+        addPigeonHole(3, 2, 1 + 6 * c);
+    SymmetryFinder::Budget budget;
+    budget.threads = 1;
+    EXPECT_NEAR(findOrder(budget), std::pow(12, 4) * 24, 1e-3);
+    budget.threads = 2;
+    EXPECT_NEAR(findOrder(budget), std::pow(12, 4) * 24, 1e-3);
+}
+
+TEST_P(SymmetryFinderTest, NoSymmetry) {
+    addClause({1});
+    addClause({1, 2});
+    addClause({-2, 3});
+    EXPECT_NEAR(findOrder(), 1, 1e-6);
+    EXPECT_EQ(_group->numberOfPermutations(), 0);
+}
+
+INSTANTIATE_TEST_CASE_P(Finders, SymmetryFinderTest,
+                        ::testing::Values(SymmetryFinder::BLISS,
+                                          SymmetryFinder::SAUCY));
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
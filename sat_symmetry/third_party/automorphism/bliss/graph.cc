@@ -66,6 +66,7 @@ AbstractGraph::AbstractGraph()
   verbstr = stdout;
 
   report_hook = 0;
+  terminate_hook = 0;
   report_user_param = 0;
 }
 
@@ -159,8 +160,14 @@ AbstractGraph::do_refine_to_equitable()
 
   eqref_hash.reset();
 
+  unsigned int nof_splitters = 0;
   while(!p.splitting_queue_is_empty())
     {
+      /* The initial refinement can be long, let the user stop it */
+      if(!in_search and terminate_hook and (++nof_splitters & 1023) == 0 and
+	 (*terminate_hook)(report_user_param, false))
+	return true;
+
       Partition::Cell* const cell = p.splitting_queue_pop();
 
       if(cell->is_unit())
@@ -681,6 +688,12 @@ AbstractGraph::search(const bool canonical, Stats& stats)
 
   make_initial_equitable_partition();
 
+  /* Stopped by the user while refining the initial partition */
+  if(terminate_hook and !p.splitting_queue_is_empty())
+    {
+      p.splitting_queue_clear();
+      return;
+    }
 
   if(verbstr and verbose_level >= 2)
     {
@@ -836,6 +849,10 @@ AbstractGraph::search(const bool canonical, Stats& stats)
    */
   while(!search_stack.empty()) 
     {
+      /* Stop at the request of the user, keeping the reported generators */
+      if(terminate_hook and (*terminate_hook)(report_user_param, true))
+	break;
+
       TreeNode&          current_node  = search_stack.back();
       const unsigned int current_level = (unsigned int)search_stack.size()-1;
 
@@ -1757,9 +1774,12 @@ AbstractGraph::find_automorphisms(Stats& stats,
 				  void (*hook)(void *user_param,
 					       unsigned int n,
 					       const unsigned int *aut),
-				  void *user_param)
+				  void *user_param,
+				  bool (*terminate)(void *user_param,
+						    bool in_search))
 {
   report_hook = hook;
+  terminate_hook = terminate;
   report_user_param = user_param;
 
   search(false, stats);
@@ -1782,10 +1802,13 @@ AbstractGraph::canonical_form(Stats& stats,
 			      void (*hook)(void *user_param,
 					   unsigned int n,
 					   const unsigned int *aut),
-			      void *user_param)
+			      void *user_param,
+			      bool (*terminate)(void *user_param,
+						bool in_search))
 {
 
   report_hook = hook;
+  terminate_hook = terminate;
   report_user_param = user_param;
 
   search(true, stats);
@@ -4017,6 +4040,15 @@ Graph::add_edge(const unsigned int vertex1, const unsigned int vertex2)
 }
 
 
+void
+Graph::add_edges(const unsigned int v,
+		 const unsigned int* first, const unsigned int* last)
+{
+  std::vector<unsigned int>& edges = vertices[v].edges;
+  edges.insert(edges.end(), first, last);
+}
+
+
 void
 Graph::change_color(const unsigned int vertex, const unsigned int color)
 {
@@ -210,18 +210,28 @@ public:
    * after the return from the hook function;
    * if you want to use the automorphism later, you have to take a copy of it.
    * Do not call any member functions in the hook.
+   * The function \a terminate (if non-null) is called, with the same
+   * \a hook_user_param, regularly while the initial partition is refined
+   * (with \a in_search false) and before each search node (with
+   * \a in_search true); the search stops as soon as it returns true.
+   * The generators reported so far are automorphisms, they generate
+   * a subgroup of the automorphism group.
    * The search statistics are copied in \a stats.
    */
   void find_automorphisms(Stats& stats,
 			  void (*hook)(void* user_param,
 				       unsigned int n,
 				       const unsigned int* aut),
-			  void* hook_user_param);
+			  void* hook_user_param,
+			  bool (*terminate)(void* user_param,
+					    bool in_search) = 0);
 
   /**
    * Otherwise the same as find_automorphisms() except that
    * a canonical labeling of the graph (a bijection on
    * {0,...,get_nof_vertices()-1}) is returned.
+   * If \a terminate stops the search, the returned labeling is not
+   * canonical (and may be null).
    * The memory allocated for the returned canonical labeling will remain
    * valid only until the next call to a member function with the exception
    * that constant member functions (for example, bliss::Graph::permute()) can
@@ -237,7 +247,9 @@ public:
 				     void (*hook)(void* user_param,
 						  unsigned int n,
 						  const unsigned int* aut),
-				     void* hook_user_param);
+				     void* hook_user_param,
+				     bool (*terminate)(void* user_param,
+						       bool in_search) = 0);
 
   /**
    * Write the graph to a file in a variant of the DIMACS format.
@@ -456,6 +468,7 @@ protected:
   void (*report_hook)(void *user_param,
 		      unsigned int n,
 		      const unsigned int *aut);
+  bool (*terminate_hook)(void *user_param, bool in_search);
   void *report_user_param;
 
 
@@ -724,6 +737,15 @@ public:
    */
   void add_edge(const unsigned int v1, const unsigned int v2);
 
+  /**
+   * Add the edges from vertex \a v to the vertices in [\a first, \a last)
+   * with one allocation, for bulk loading the adjacency lists of a graph.
+   * The edges are only added to the list of \a v: the list of each
+   * other end must get its own edge back to \a v.
+   */
+  void add_edges(const unsigned int v,
+                 const unsigned int* first, const unsigned int* last);
+
   /**
    * Change the color of the vertex \a vertex to \a color.
    */
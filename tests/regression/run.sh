@@ -0,0 +1,123 @@
+#!/bin/bash
+#
+# Regression runs of minisat_core on the instances of this directory. Each
+# instance states its answer in a "c expect:" line, and the model of a
+# satisfiable instance is checked against its clauses. The instances are
+# solved with the symmetries of their .txt file and of the in-process
+# finders, with and without cosy, the symmetry propagation and the static
+# breaking, and gzipped, then from corrupt symmetry cache entries and corrupt
+# or foreign snapshots, which must be ignored. The runs are limited to 1 GB of
+# memory, which a header over-claiming its sizes must not exhaust.
+#
+# usage: run.sh [minisat_core]
+#
+# Prints the failed runs and exits with 1 if there is any.
+
+MINISAT=${1:-$(dirname $0)/../../build/release/bin/minisat_core}
+DIR=$(dirname $0)
+TMP=$(mktemp -d)
+trap "rm -rf $TMP" EXIT
+
+MODES=(""
+       "-no-cosy"
+       "-no-dynamic-breaking"
+       "-no-cosy -no-dynamic-breaking"
+       "-sbp-static"
+       "-sym-finder=bliss"
+       "-sym-finder=saucy"
+       "-sym-finder=bliss -sbp-static"
+       "-sym-finder=saucy -sbp-static"
+       "-sym-finder=bliss -sbp-static -no-cosy -no-dynamic-breaking"
+       "-sym-finder=bliss -sym-matrix"
+       "-sym-finder=bliss -sym-matrix -no-cosy"
+       "-sym-finder=bliss -sym-matrix -sbp-static"
+       "-sym-matrix")
+
+runs=0
+failures=0
+
+# Satisfied if each clause of the file has a literal of the model, given in
+# the "v" lines of the solver output on the standard input
+verify() {
+    awk 'NR == FNR { if ($1 == "v") for (i = 2; i <= NF; i++) model[$i] = 1
+                     next }
+         /^[cp%]/ || NF == 0 { next }
+         { sat = 0
+           for (i = 1; i < NF; i++) if ($i in model) sat = 1
+           if (!sat) bad = 1 }
+         END { exit bad }' - "$1"
+}
+
+# check <cnf> <description> <options>...
+check() {
+    local cnf=$1 what=$2
+    shift 2
+    local expect=$(zcat -f $cnf | grep -m1 "^c expect:" | awk '{print $3}')
+    local out=$(ulimit -v 1048576; timeout 60 $MINISAT -verb=0 "$@" $cnf 2>&1)
+    local result=$(echo "$out" | grep -m1 -E "^(s )?(UN)?SATISFIABLE$" | sed 's/^s //')
+
+    runs=$((runs + 1))
+    if [ "$result" != "$expect" ]; then
+        echo "FAIL $(basename $cnf) [$what $*]: ${result:-no answer}, expected $expect"
+        failures=$((failures + 1))
+    elif [ "$result" == "SATISFIABLE" ] && ! echo "$out" | verify <(zcat -f $cnf); then
+        echo "FAIL $(basename $cnf) [$what $*]: the model falsifies a clause"
+        failures=$((failures + 1))
+    fi
+}
+
+for cnf in $DIR/*.cnf; do
+    for mode in "${MODES[@]}"; do
+        check $cnf "" $mode
+    done
+
+    # Gzipped, the symmetry file too
+    gz=$TMP/$(basename $cnf).gz
+    gzip -c $cnf > $gz
+    [ -f $cnf.txt ] && gzip -c $cnf.txt > $gz.txt
+    check $gz "gzip"
+    check $gz "gzip" -sym-finder=bliss
+    rm -f $gz $gz.txt
+
+    # A truncated entry, then the entry of another instance
+    cache=$TMP/cache
+    rm -rf $cache
+    check $cnf "cache" -sym-finder=bliss -sym-cache=$cache
+    for entry in $cache/*.sym; do
+        [ -f $entry ] || continue
+        truncate -s $(($(stat -c %s $entry) / 2)) $entry
+    done
+    check $cnf "truncated cache" -sym-finder=bliss -sym-cache=$cache
+    for entry in $cache/*.sym; do
+        [ -f $entry ] || continue
+        printf "[\n(1,2)(3,4)\n]\n" > $entry
+    done
+    check $cnf "foreign cache" -sym-finder=bliss -sym-cache=$cache
+    check $cnf "cache" -sym-finder=bliss -sym-cache=$cache
+
+    # A truncated snapshot, then a snapshot with a byte changed
+    for finder in file bliss; do
+        snapshot=$TMP/snapshot
+        rm -f $snapshot
+        check $cnf "snapshot" -sym-finder=$finder -snapshot=$snapshot
+        [ -f $snapshot ] || continue
+        size=$(stat -c %s $snapshot)
+        truncate -s $((size - 4)) $snapshot
+        check $cnf "truncated snapshot" -sym-finder=$finder -snapshot=$snapshot
+        check $cnf "snapshot" -sym-finder=$finder -snapshot=$snapshot
+        printf "\xff" | dd of=$snapshot bs=1 seek=$((size - 8)) conv=notrunc \
+                           2> /dev/null
+        check $cnf "corrupt snapshot" -sym-finder=$finder -snapshot=$snapshot
+    done
+done
+
+# The snapshot of another instance of the same size and modification time
+printf "c expect: SATISFIABLE\np cnf 2 2\n1 2 0\n-1 0\n" > $TMP/a.cnf
+printf "c expect: SATISFIABLE\np cnf 2 2\n1 2 0\n-2 0\n" > $TMP/b.cnf
+touch -r $TMP/a.cnf $TMP/b.cnf
+rm -f $TMP/snapshot
+check $TMP/a.cnf "snapshot" -sym-finder=bliss -snapshot=$TMP/snapshot
+check $TMP/b.cnf "foreign snapshot" -sym-finder=bliss -snapshot=$TMP/snapshot
+
+echo "$runs runs, $failures failures"
+[ $failures -eq 0 ]